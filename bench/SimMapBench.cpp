@@ -0,0 +1,674 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-07.
+//
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <simmap/simmap.h>
+#include <base/functions.h>
+#include <generator/NetworkGenerator.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+
+/** Struct to define a benchmark scenario on one of the test tracks */
+struct Track {
+    std::string file;               /**< the map file */
+    std::vector<std::string> roads; /**< the track of the agents */
+    std::string edge;               /**< the start edge of the agents */
+    double edgeLength;              /**< the length of the start edge */
+};
+
+
+/** The test tracks */
+static const Track TRACKS[] = {
+        {TRACKS_DIR "/CircleR100.xodr",                        {"1", "-2"}, "R1-LS1-R1",    157.0},
+        {TRACKS_DIR "/Straight10000.xodr",                     {"1"},       "R1-LS1-R1",    10000.0},
+        {TRACKS_DIR "/sample1.1.xodr",                         {"17"},      "R17-LS1-R1",   1598.0},
+        {TRACKS_DIR "/KA-Suedtangente-atlatec-Roadshape.xodr", {"6481"},    "R6481-LS1-R1", 160.0},
+};
+
+
+/** Agent counts and path lengths */
+static void agentsAndLength(benchmark::internal::Benchmark *b) {
+
+    b->ArgNames({"agents", "length"});
+
+    for (int agents : {1, 10, 100})
+        for (int length : {50, 200, 1000})
+            b->Args({agents, length});
+
+}
+
+
+/**
+ * Loads the map once per track and returns the ID
+ * @param track Track
+ * @return Map ID
+ */
+static simmap::id_type_t mapID(const Track &track) {
+
+    static std::map<std::string, simmap::id_type_t> ids{};
+
+    if (ids.find(track.file) == ids.end()) {
+
+        simmap::id_type_t id;
+        if (simmap::loadMap(track.file.c_str(), id) != 0)
+            throw std::runtime_error("Could not load " + track.file);
+
+        ids[track.file] = id;
+
+    }
+
+    return ids.at(track.file);
+
+}
+
+
+/**
+ * @brief Agents on a track for the time of a benchmark
+ */
+class Agents {
+
+    const Track &_track;
+    unsigned long _n;
+    double _length;
+    std::string _error{};
+
+public:
+
+    Agents(const Track &track, unsigned long n, double length) : _track(track), _n(n), _length(length) {
+
+        simmap::id_type_t id;
+        try {
+            id = mapID(track);
+        } catch (const std::exception &e) {
+            _error = e.what();
+            return;
+        }
+
+        // get road IDs
+        std::vector<const char *> roads;
+        for (const auto &r : _track.roads)
+            roads.push_back(r.c_str());
+
+        for (unsigned long i = 1; i <= n; ++i) {
+
+            simmap::err_type_t err;
+            if ((err = simmap::registerAgent(i, id)) != 0)
+                _error = "Could not register agent " + std::to_string(i);
+            else if ((err = simmap::setTrack(i, roads.data(), roads.size())) != 0)
+                _error = "Could not set the track of agent " + std::to_string(i);
+            else if ((err = place(i)) != 0)
+                _error = "Could not place agent " + std::to_string(i);
+
+            if (err != 0) {
+                _error += " (error " + std::to_string(err) + ")";
+                return;
+            }
+
+        }
+
+    }
+
+
+    ~Agents() {
+
+        for (unsigned long i = 1; i <= _n; ++i)
+            simmap::unregisterAgent(i);
+
+    }
+
+
+    /**
+     * Places the agent on the start edge (agents are distributed along the edge)
+     * @param i Agent ID
+     * @return Error code
+     */
+    simmap::err_type_t place(unsigned long i) const {
+
+        double lenFront = _length, lenBack = 50.0;
+        simmap::MapPosition pos{_track.edge.c_str(), std::fmod(i * 1.5, _track.edgeLength - 1.0), 0.0};
+
+        return simmap::setMapPosition(i, pos, lenFront, lenBack);
+
+    }
+
+
+    /**
+     * Returns whether all agents were set up successfully
+     * @return Flag
+     */
+    bool ok() const {
+
+        return _error.empty();
+
+    }
+
+
+    /**
+     * Returns the error of the setup (empty if successful)
+     * @return Error message
+     */
+    const std::string &error() const {
+
+        return _error;
+
+    }
+
+
+    /**
+     * Returns the number of agents
+     * @return Number of agents
+     */
+    unsigned long size() const {
+
+        return _n;
+
+    }
+
+
+    /**
+     * Returns the path length
+     * @return Path length
+     */
+    double length() const {
+
+        return _length;
+
+    }
+
+};
+
+
+static void BM_LoadMap(benchmark::State &state, const Track &track) {
+
+    for (auto _ : state) {
+
+        simmap::id_type_t id = 0;
+        if (simmap::loadMap(track.file.c_str(), id) != 0) {
+            state.SkipWithError("Could not load map");
+            break;
+        }
+
+        state.PauseTiming();
+        simmap::unloadMap(id);
+        state.ResumeTiming();
+
+    }
+
+}
+
+
+static void BM_SetMapPosition(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    unsigned long i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(agents.place(i++ % agents.size() + 1));
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_Move(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        auto aid = i++ % agents.size() + 1;
+
+        double lenFront = agents.length(), lenBack = 50.0;
+        if (simmap::move(aid, 1.0, 0.0, lenFront, lenBack) != 0)
+            agents.place(aid); // end of track reached
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_MoveHysteresis(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    // extend the path to twice the requested lengths
+    for (unsigned long i = 1; i <= agents.size(); ++i)
+        simmap::setPathHysteresis(i, 2.0, agents.length(), 50.0);
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        auto aid = i++ % agents.size() + 1;
+
+        double lf, lb;
+        if (simmap::move(aid, 1.0, 0.0, lf, lb) != 0)
+            agents.place(aid); // end of track reached
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_Match(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    // get positions one meter ahead of the agents
+    std::vector<simmap::Position> positions(agents.size());
+    for (unsigned long i = 0; i < agents.size(); ++i) {
+
+        double s = 1.0;
+        simmap::HorizonInformation hor{};
+        simmap::horizon(i + 1, &s, &hor, 1);
+
+        positions[i] = simmap::Position{hor.x, hor.y, 0.0, hor.psi, hor.kappa};
+
+    }
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        auto k = i++ % agents.size();
+
+        simmap::MapPosition mapPos{};
+        benchmark::DoNotOptimize(simmap::match(k + 1, positions[k], 1.0, mapPos));
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_Horizon(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    // grid points every meter along the path
+    auto n = static_cast<unsigned long>(agents.length());
+    std::vector<double> grid(n);
+    for (unsigned long j = 0; j < n; ++j)
+        grid[j] = static_cast<double>(j);
+
+    std::vector<simmap::HorizonInformation> hor(n);
+
+    unsigned long i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simmap::horizon(i++ % agents.size() + 1, grid.data(), hor.data(), n));
+
+    state.SetItemsProcessed(state.iterations() * n);
+
+}
+
+
+static void BM_Lanes(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    std::vector<simmap::LaneInformation> lanes(32);
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        unsigned long n = lanes.size();
+        benchmark::DoNotOptimize(simmap::lanes(i++ % agents.size() + 1, lanes.data(), n));
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_Objects(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    std::vector<simmap::ObjectInformation> objects(32);
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        unsigned long n = objects.size();
+        benchmark::DoNotOptimize(simmap::objects(i++ % agents.size() + 1, objects.data(), n));
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_Targets(benchmark::State &state, const Track &track) {
+
+    Agents agents(track, static_cast<unsigned long>(state.range(0)), state.range(1));
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    std::vector<simmap::TargetInformation> targets(32);
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        unsigned long n = targets.size();
+        benchmark::DoNotOptimize(simmap::targets(i++ % agents.size() + 1, targets.data(), n));
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+// register benchmarks for all tracks
+#define TRACK_BENCHMARK(fn)                                                         \
+    BENCHMARK_CAPTURE(fn, CircleR100, TRACKS[0])->Apply(agentsAndLength);           \
+    BENCHMARK_CAPTURE(fn, Straight10000, TRACKS[1])->Apply(agentsAndLength);        \
+    BENCHMARK_CAPTURE(fn, sample1_1, TRACKS[2])->Apply(agentsAndLength);            \
+    BENCHMARK_CAPTURE(fn, KA_Suedtangente, TRACKS[3])->Apply(agentsAndLength)
+
+BENCHMARK_CAPTURE(BM_LoadMap, CircleR100, TRACKS[0])->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LoadMap, Straight10000, TRACKS[1])->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LoadMap, sample1_1, TRACKS[2])->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LoadMap, KA_Suedtangente, TRACKS[3])->Unit(benchmark::kMillisecond);
+
+TRACK_BENCHMARK(BM_SetMapPosition);
+TRACK_BENCHMARK(BM_Move);
+TRACK_BENCHMARK(BM_MoveHysteresis);
+TRACK_BENCHMARK(BM_Match);
+TRACK_BENCHMARK(BM_Horizon);
+TRACK_BENCHMARK(BM_Lanes);
+TRACK_BENCHMARK(BM_Objects);
+TRACK_BENCHMARK(BM_Targets);
+
+
+// ------------------------------------------------------------------------------
+// generated networks (scaling with the map size)
+// ------------------------------------------------------------------------------
+
+/** Struct to store a generated network */
+struct GeneratedMap {
+    Track track;                          /**< the track along the first row */
+    simmap::generator::Network network;   /**< the network information */
+    double fileSize;                      /**< the size of the file in bytes */
+};
+
+
+/**
+ * Returns the resident memory of the process
+ * @return Resident memory in bytes (0 if not available)
+ */
+static double residentMemory() {
+
+#ifdef __linux__
+
+    double size = 0.0, resident = 0.0;
+
+    std::ifstream statm("/proc/self/statm");
+    statm >> size >> resident;
+
+    return resident * static_cast<double>(sysconf(_SC_PAGESIZE));
+
+#else
+
+    return 0.0;
+
+#endif
+
+}
+
+
+/**
+ * Generates a grid network with the given number of roads (once per size)
+ * @param roads Number of roads
+ * @return Generated map
+ */
+static const GeneratedMap &generated(unsigned int roads) {
+
+    static std::map<unsigned int, GeneratedMap> maps{};
+
+    if (maps.find(roads) == maps.end()) {
+
+        simmap::generator::Settings settings;
+        settings.roads = roads;
+
+        // generate file
+        auto file = base::string_format("%s/grid%u.xodr", GENERATED_DIR, roads);
+        simmap::generator::NetworkGenerator generator(settings);
+        auto network = generator.write(file);
+
+        // get file size
+        std::ifstream in(file, std::ifstream::ate | std::ifstream::binary);
+        auto size = static_cast<double>(in.tellg());
+
+        // agents start on the first road of the track
+        auto len = settings.blockLength - 2.0 * settings.junctionRadius;
+        maps[roads] = GeneratedMap{Track{file, network.track, "R" + network.track.front() + "-LS1-R1", len},
+                                   network, size};
+
+    }
+
+    return maps.at(roads);
+
+}
+
+
+static void BM_LoadGenerated(benchmark::State &state) {
+
+    const auto &map = generated(static_cast<unsigned int>(state.range(0)));
+    simmap::id_type_t id;
+
+    // measure memory of a single map
+    auto mem = residentMemory();
+    if (simmap::loadMap(map.track.file.c_str(), id) != 0) {
+        state.SkipWithError("Could not load map");
+        return;
+    }
+
+    mem = residentMemory() - mem;
+    simmap::unloadMap(id);
+
+    for (auto _ : state) {
+
+        simmap::loadMap(map.track.file.c_str(), id);
+
+        state.PauseTiming();
+        simmap::unloadMap(id);
+        state.ResumeTiming();
+
+    }
+
+    state.counters["roads"] = map.network.roads + map.network.connectingRoads;
+    state.counters["junctions"] = map.network.junctions;
+    state.counters["km"] = map.network.length / 1000.0;
+    state.counters["fileBytes"] = map.fileSize;
+    state.counters["memoryBytes"] = mem;
+
+}
+
+
+static void BM_QueryGenerated(benchmark::State &state) {
+
+    const auto &map = generated(static_cast<unsigned int>(state.range(0)));
+    Agents agents(map.track, 10, 200.0);
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    // grid points
+    double grid[] = {0.0, 10.0, 20.0, 50.0, 100.0, 150.0, 200.0};
+    simmap::HorizonInformation hor[7];
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        auto aid = i++ % agents.size() + 1;
+
+        // move and get horizon
+        double lenFront = agents.length(), lenBack = 50.0;
+        if (simmap::move(aid, 1.0, 0.0, lenFront, lenBack) != 0)
+            agents.place(aid); // end of track reached
+
+        benchmark::DoNotOptimize(simmap::horizon(aid, grid, hor, 7));
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["roads"] = map.network.roads + map.network.connectingRoads;
+
+}
+
+
+static void BM_LongPathGenerated(benchmark::State &state) {
+
+    const auto &map = generated(1024);
+    Agents agents(map.track, 10, static_cast<double>(state.range(0)));
+
+    if (!agents.ok()) {
+        state.SkipWithError(agents.error().c_str());
+        return;
+    }
+
+    // grid points every 10 meters along the path (the path consists of many short lanes)
+    auto n = static_cast<unsigned long>(agents.length() / 10.0);
+    std::vector<double> grid(n);
+    for (unsigned long j = 0; j < n; ++j)
+        grid[j] = 10.0 * static_cast<double>(j);
+
+    std::vector<simmap::HorizonInformation> hor(n);
+
+    unsigned long i = 0;
+    for (auto _ : state) {
+
+        auto aid = i++ % agents.size() + 1;
+
+        // move and get horizon
+        double lenFront = agents.length(), lenBack = 50.0;
+        if (simmap::move(aid, 1.0, 0.0, lenFront, lenBack) != 0)
+            agents.place(aid); // end of track reached
+
+        benchmark::DoNotOptimize(simmap::horizon(aid, grid.data(), hor.data(), n));
+
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+}
+
+
+static void BM_MatchGlobalGenerated(benchmark::State &state) {
+
+    const auto &map = generated(static_cast<unsigned int>(state.range(0)));
+
+    // get positions every 5 meters along the path of an agent
+    std::vector<simmap::Position> positions{};
+    {
+        Agents agents(map.track, 1, 1000.0);
+
+        if (!agents.ok()) {
+            state.SkipWithError(agents.error().c_str());
+            return;
+        }
+
+        std::vector<double> grid(200);
+        std::vector<simmap::HorizonInformation> hor(grid.size());
+        for (size_t j = 0; j < grid.size(); ++j)
+            grid[j] = 5.0 * static_cast<double>(j);
+
+        simmap::horizon(1, grid.data(), hor.data(), grid.size());
+
+        for (const auto &h : hor)
+            if (std::isfinite(h.s))
+                positions.push_back(simmap::Position{h.x, h.y, 0.0, h.psi, h.kappa});
+    }
+
+    // match all positions at once
+    std::vector<simmap::MapPosition> mapPos(positions.size());
+    auto id = mapID(map.track);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simmap::matchGlobal(id, positions.data(), mapPos.data(), positions.size()));
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(positions.size()));
+    state.counters["roads"] = map.network.roads + map.network.connectingRoads;
+
+}
+
+
+BENCHMARK(BM_LoadGenerated)->ArgName("roads")->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_QueryGenerated)->ArgName("roads")->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_LongPathGenerated)->ArgName("length")->RangeMultiplier(4)->Range(250, 4000);
+BENCHMARK(BM_MatchGlobalGenerated)->ArgName("roads")->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_MAIN();
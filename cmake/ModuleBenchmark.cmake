@@ -0,0 +1,36 @@
+# ------------------------------------------------------------------------------
+# Benchmarks
+#
+# * Include this file when benchmarks are enabled
+# * Put your benchmarks in the root/bench folder
+# * add a CMakeLists.txt and use add_benchmark(...) macro
+# * the target run_<name> runs the benchmark and writes <name>.json to the build directory
+# ------------------------------------------------------------------------------
+
+# define macro
+macro(add_benchmark BENCHNAME)
+
+    # link library
+    target_link_libraries(${BENCHNAME} PRIVATE benchmark::benchmark)
+    set_target_properties(${BENCHNAME} PROPERTIES FOLDER "Benchmarks")
+
+    # run target with JSON output
+    add_custom_target(run_${BENCHNAME}
+            COMMAND $<TARGET_FILE:${BENCHNAME}>
+            --benchmark_out=${CMAKE_BINARY_DIR}/${BENCHNAME}.json
+            --benchmark_out_format=json
+            DEPENDS ${BENCHNAME}
+            WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+            COMMENT "Running benchmark ${BENCHNAME}")
+
+endmacro()
+
+
+# message
+message(STATUS "Benchmarks (google benchmark) enabled")
+
+# find google benchmark
+find_package(benchmark REQUIRED)
+
+# add benchmark folder
+add_subdirectory(${PROJECT_SOURCE_DIR}/bench)
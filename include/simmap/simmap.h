@@ -57,10 +57,14 @@ namespace simmap {
     // C compatibility
     typedef struct Position Position;
     typedef struct MapPosition MapPosition;
+    typedef struct MapHandlePosition MapHandlePosition;
+    typedef struct TrackHandle TrackHandle;
     typedef struct ObjectInformation ObjectInformation;
     typedef struct LaneInformation LaneInformation;
     typedef struct TargetInformation TargetInformation;
     typedef struct HorizonInformation HorizonInformation;
+    typedef struct CallStatistics CallStatistics;
+    typedef struct MapOptions MapOptions;
 
 
     // \todo: error codes
@@ -84,7 +88,48 @@ namespace simmap {
 
 
     /**
-     * Unload map
+     * Load map by passing the file name and the loading options. With a curve tolerance, the road geometry is baked
+     * into lookup tables, which are interpolated instead of evaluating the geometry exactly. With the routing
+     * hierarchy flag, contraction hierarchies are created for the routing and cached next to the map file
+     * @param filename File name
+     * @param options Loading options
+     * @param id ID of the segment
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t loadMap(const char *filename, MapOptions options, id_type_t &id);
+
+
+    /**
+     * Starts loading a map in the background. The ID is reserved immediately, the map can be used as soon as
+     * mapStatus reports READY
+     * @param filename File name
+     * @param id ID of the segment
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t loadMapAsync(const char *filename, id_type_t &id);
+
+
+    /**
+     * Starts loading a map in the background with the given loading options (see loadMap)
+     * @param filename File name
+     * @param options Loading options
+     * @param id ID of the segment
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t loadMapAsync(const char *filename, MapOptions options, id_type_t &id);
+
+
+    /**
+     * Returns the loading state of the given map
+     * @param id Map ID
+     * @param status Loading state of the map
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t mapStatus(id_type_t id, MapStatus &status);
+
+
+    /**
+     * Unload map. A map being loaded is discarded without waiting (the map is deleted when loading is finished)
      * @param id Map ID
      * @return Error code (0 = no error)
      */
@@ -118,6 +163,16 @@ namespace simmap {
     SHARED_EXPORT err_type_t setTrack(id_type_t agentID, const char **roadIds, unsigned long n);
 
 
+    /**
+     * Sets the agent's track by road handles (see roadHandle)
+     * @param agentID Agent ID
+     * @param roads Road handles with direction, an array of n entries
+     * @param n Number of roads in track
+     * @return Error code
+     */
+    SHARED_EXPORT err_type_t setTrack(id_type_t agentID, const TrackHandle *roads, unsigned long n);
+
+
     /**
      * Returns the absolute position in the world based on the road, the long. position in the road and the lane.
      * @param agentID Agent ID
@@ -139,6 +194,18 @@ namespace simmap {
     SHARED_EXPORT err_type_t setMapPosition(id_type_t agentID, MapPosition mapPos, double &lenFront, double &lenBack);
 
 
+    /**
+     * Sets the map position of the agent by the edge handle (see edgeHandle)
+     * @param agentID Agent ID
+     * @param mapPos Map position to be set
+     * @param lenFront Length to the front of the path (value is used for update)
+     * @param lenBack Length to the back of the path (value is used for update)
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t
+    setMapPosition(id_type_t agentID, MapHandlePosition mapPos, double &lenFront, double &lenBack);
+
+
     /**
      * Returns the map position of the given agent
      * @param agentID Agent ID
@@ -148,6 +215,35 @@ namespace simmap {
     SHARED_EXPORT err_type_t getMapPosition(id_type_t agentID, MapPosition &mapPos);
 
 
+    /**
+     * Returns the map position of the given agent with the edge handle
+     * @param agentID Agent ID
+     * @param mapPos Map position
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t getMapPosition(id_type_t agentID, MapHandlePosition &mapPos);
+
+
+    /**
+     * Returns the handle of the given edge. The handle is valid until the map is unloaded
+     * @param mapID Map ID
+     * @param edgeID Edge ID
+     * @param handle Handle of the edge
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t edgeHandle(id_type_t mapID, const char *edgeID, unsigned long &handle);
+
+
+    /**
+     * Returns the handle of the given road. The handle is valid until the map is unloaded
+     * @param mapID Map ID
+     * @param roadID Road ID
+     * @param handle Handle of the road
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t roadHandle(id_type_t mapID, const char *roadID, unsigned long &handle);
+
+
     /**
      * Returns the map position based on the given global coordinates
      * @param agentID Agent ID
@@ -160,12 +256,12 @@ namespace simmap {
 
 
     /**
-     * Moves the given agent by the distance of ds
+     * Moves the given agent by the distance of ds (the path is updated by the hysteresis, see setPathHysteresis)
      * @param agentID Agent id
      * @param distance Distance to be moved
      * @param lateralPosition Lateral position in lane
-     * @param lenFront Length to the front of the path (value is used for update)
-     * @param lenBack Length to the back of the path (value is used for update)
+     * @param lenFront Length to the front of the path (value is used for update, output only with a hysteresis)
+     * @param lenBack Length to the back of the path (value is used for update, output only with a hysteresis)
      * @return Error code (0 = no error)
      */
     SHARED_EXPORT err_type_t
@@ -222,6 +318,122 @@ namespace simmap {
      */
     SHARED_EXPORT err_type_t targets(id_type_t agentID, TargetInformation *targets, unsigned long &n);
 
+
+    /**
+     * Locates the given position in the map (without agent or path), i.e. returns the lanes which contain the position,
+     * sorted by the lateral distance to the lane center
+     * @param mapID Map ID
+     * @param x x coordinate
+     * @param y y coordinate
+     * @param positions Map positions to be returned
+     * @param n Number of positions (pre-set for maximum number)
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t locate(id_type_t mapID, double x, double y, MapPosition *positions, unsigned long &n);
+
+
+    /**
+     * Locates the given position in the map (without agent or path), i.e. returns the lanes which contain the position,
+     * sorted by the lateral distance to the lane center. Lanes with an angle of more than 90 deg to the heading are
+     * ignored
+     * @param mapID Map ID
+     * @param x x coordinate
+     * @param y y coordinate
+     * @param heading Heading
+     * @param positions Map positions to be returned
+     * @param n Number of positions (pre-set for maximum number)
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t
+    locate(id_type_t mapID, double x, double y, double heading, MapPosition *positions, unsigned long &n);
+
+
+    /**
+     * Matches the given global position to the best fitting lane of the map (without agent or path). The lanes are
+     * scored by the lateral distance and the difference between the lane direction and the heading (phi, NAN to
+     * ignore the heading)
+     * @param mapID Map ID
+     * @param pos Absolute global position
+     * @param mapPos Matched map position
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t matchGlobal(id_type_t mapID, Position pos, MapPosition &mapPos);
+
+
+    /**
+     * Matches the given global positions to the best fitting lanes of the map (without agent or path). Positions
+     * which cannot be matched get an edge ID of nullptr and the function returns an error code, the other positions
+     * are matched anyway
+     * @param mapID Map ID
+     * @param pos Absolute global positions, an array of n entries
+     * @param mapPos Matched map positions, an array of n entries
+     * @param n Number of positions
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t
+    matchGlobal(id_type_t mapID, const Position *pos, MapPosition *mapPos, unsigned long n);
+
+
+    /**
+     * Finds the shortest route (by A* on the lanes, lane changes included) from the agent's current position to the
+     * given target position and sets the roads of the route as the agent's track. If the map is loaded with the
+     * routing hierarchy, routes to other roads are found by contraction hierarchies. The position of the agent is kept
+     * @param agentID Agent ID
+     * @param targetEdge ID of the target lane
+     * @param targetS Longitudinal position in the target lane
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t route(id_type_t agentID, const char *targetEdge, double targetS);
+
+
+    /**
+     * Returns the tree of the lanes reachable from the agent's current position (without lane changes). The nodes are
+     * sorted breadth-first, the parent of a node is stored before the node and the children of a node are sorted by
+     * the probability (most probable child first). Loops end a branch. The trees are memoized per map
+     * @param agentID Agent ID
+     * @param distance Maximum distance from the position (lanes starting behind are not added)
+     * @param depth Maximum number of lanes after the current lane
+     * @param nodes Nodes to be returned
+     * @param n Number of nodes (pre-set for maximum number)
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t
+    horizonTree(id_type_t agentID, double distance, unsigned long depth, HorizonTreeNode *nodes, unsigned long &n);
+
+
+    /**
+     * Sets the path hysteresis of the agent for move. With a factor larger than one, the path is only updated when the
+     * requested lengths are not met (the path is then extended to factor times the requested lengths) or when the
+     * lengths exceed factor times the requested lengths (the path is then trimmed to the requested lengths). The
+     * lengths returned by move can therefore be larger than the requested lengths, the lengths passed to move are not
+     * used. A factor of one (default) updates the path on each move to the lengths passed to move
+     * @param agentID Agent ID
+     * @param factor High-water factor of the path lengths (at least one)
+     * @param lenFront Requested length to the front of the path
+     * @param lenBack Requested length to the back of the path
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t setPathHysteresis(id_type_t agentID, double factor, double lenFront, double lenBack);
+
+
+    /**
+     * Writes the metrics of all library functions (calls, errors, error codes and latency histograms) in the
+     * Prometheus text format
+     * @param text Buffer for the zero-terminated text
+     * @param n Size of the buffer (pre-set), the required size is returned
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t metrics(char *text, unsigned long &n);
+
+
+    /**
+     * Returns the call statistics of all library functions
+     * @param stats Statistics to be returned
+     * @param n Number of statistics (pre-set for maximum number)
+     * @return Error code (0 = no error)
+     */
+    SHARED_EXPORT err_type_t statistics(CallStatistics *stats, unsigned long &n);
+
 }
 
 #endif // SIMMAP_SIMMAP_H
@@ -52,6 +52,11 @@ namespace simmap {
         ALLOWED, NOT_ALLOWED, NOT_POSSIBLE
     };
 
+    /** Enum to define the loading state of a map. */
+    enum MapStatus {
+        LOADING, READY, FAILED
+    };
+
 
     /** Struct to define a point including angle and curvature in the regarding coordinate system. */
     struct Position {
@@ -71,6 +76,21 @@ namespace simmap {
     };
 
 
+    /** Struct to define a position in a map by the handle of the edge */
+    struct MapHandlePosition {
+        unsigned long edge; /**< the edge handle */
+        double longPos;     /**< the longitudinal position on the edge */
+        double latPos;      /**< the lateral position on the edge */
+    };
+
+
+    /** Struct to define an element of a track by the handle of the road */
+    struct TrackHandle {
+        unsigned long road; /**< the road handle */
+        int backwards;      /**< flag whether the road is driven in backward direction */
+    };
+
+
     /** Struct to define a point in a virtual horizon */
     struct HorizonInformation {
         double s;                /**< the longitudinal distance to the point */
@@ -84,6 +104,17 @@ namespace simmap {
     };
 
 
+    /** Struct to define a node of a horizon tree (a lane reachable from the position of the agent) */
+    struct HorizonTreeNode {
+        const char *id;         /**< the ID of the lane */
+        unsigned long edge;     /**< the handle of the lane */
+        long parent;            /**< the index of the parent node (-1 for the root) */
+        double distance;        /**< the distance from the position to the start of the lane (negative for the root) */
+        double length;          /**< the length of the lane */
+        double probability;     /**< the probability to drive along the lane */
+    };
+
+
     /** Struct to define an object */
     struct ObjectInformation {
         const char *id;         /**< the ID of the object */
@@ -116,6 +147,26 @@ namespace simmap {
         int lane;           /**< the lane, the target is corresponding to */
     };
 
+
+
+    /** Struct to define the options for loading a map */
+    struct MapOptions {
+        double curveTolerance;  /**< the tolerance of the baked road geometry (0 = exact evaluation) */
+        int routingHierarchy;   /**< flag to use contraction hierarchies for the routing (cached in <map file>.ch) */
+    };
+
+
+    /** Struct to define the call statistics of a library function */
+    struct CallStatistics {
+        const char *name;       /**< the name of the function */
+        unsigned long calls;    /**< the number of calls */
+        unsigned long errors;   /**< the number of calls which returned an error */
+        double meanLatency;     /**< the mean latency in seconds */
+        double p50Latency;      /**< the median latency in seconds (estimated from the histogram) */
+        double p99Latency;      /**< the 99th percentile of the latency in seconds (estimated from the histogram) */
+        double p999Latency;     /**< the 99.9th percentile of the latency in seconds (estimated from the histogram) */
+    };
+
 }
 
 inline std::ostream &operator<< (std::ostream &os, const simmap::Position& pos) {
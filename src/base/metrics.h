@@ -0,0 +1,360 @@
+/*
+ * metrics.h
+ *
+ * MIT License
+ *
+ * Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ *         of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ *         to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *         copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ *         copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *         AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMMAP_BASE_METRICS_H
+#define SIMMAP_BASE_METRICS_H
+
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace base {
+namespace metrics {
+
+
+    /** Number of latency buckets (without the +Inf bucket) */
+    const size_t N_BUCKETS = 22;
+
+
+    /**
+     * Returns the upper bounds of the latency buckets in seconds (1 us ... 10 s)
+     * @return Bucket bounds
+     */
+    inline const std::array<double, N_BUCKETS> &bucketBounds() {
+
+        static const std::array<double, N_BUCKETS> bounds{{
+                1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3,
+                5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0}};
+
+        return bounds;
+
+    }
+
+
+    /**
+     * @brief Lock-free latency histogram
+     * Counts are updated with relaxed atomic increments, so recording is wait-free and can be done from any thread.
+     */
+    class Histogram {
+
+        std::array<std::atomic<uint64_t>, N_BUCKETS + 1> _counts{};
+        std::atomic<uint64_t> _sum{0}; // in nanoseconds
+
+    public:
+
+        Histogram() {
+
+            for (auto &c : _counts)
+                c.store(0, std::memory_order_relaxed);
+
+        }
+
+
+        /**
+         * Records a value
+         * @param seconds Value in seconds
+         */
+        void observe(double seconds) {
+
+            auto &b = bucketBounds();
+            auto i = static_cast<size_t>(std::lower_bound(b.begin(), b.end(), seconds) - b.begin());
+
+            _counts[i].fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(static_cast<uint64_t>(std::max(0.0, seconds) * 1e9), std::memory_order_relaxed);
+
+        }
+
+
+        /**
+         * Returns the number of recorded values
+         * @return Number of values
+         */
+        uint64_t count() const {
+
+            uint64_t n = 0;
+            for (auto &c : _counts)
+                n += c.load(std::memory_order_relaxed);
+
+            return n;
+
+        }
+
+
+        /**
+         * Returns the sum of all recorded values
+         * @return Sum in seconds
+         */
+        double sum() const {
+
+            return static_cast<double>(_sum.load(std::memory_order_relaxed)) * 1e-9;
+
+        }
+
+
+        /**
+         * Estimates the quantile by linear interpolation inside the bucket
+         * @param q Quantile (0..1)
+         * @return Estimated value in seconds
+         */
+        double quantile(double q) const {
+
+            auto &b = bucketBounds();
+
+            // copy counts
+            std::array<uint64_t, N_BUCKETS + 1> c{};
+            uint64_t n = 0;
+            for (size_t i = 0; i < c.size(); ++i)
+                n += (c[i] = _counts[i].load(std::memory_order_relaxed));
+
+            if (n == 0)
+                return 0.0;
+
+            // find bucket
+            auto rank = q * static_cast<double>(n);
+            double cum = 0.0;
+            for (size_t i = 0; i < N_BUCKETS; ++i) {
+
+                if (cum + static_cast<double>(c[i]) >= rank && c[i] != 0) {
+
+                    double lower = i == 0 ? 0.0 : b[i - 1];
+                    return lower + (b[i] - lower) * (rank - cum) / static_cast<double>(c[i]);
+
+                }
+
+                cum += static_cast<double>(c[i]);
+
+            }
+
+            // value in +Inf bucket
+            return b[N_BUCKETS - 1];
+
+        }
+
+
+        /**
+         * Writes the histogram series in the Prometheus text format
+         * @param os Output stream
+         * @param name Metric name
+         * @param labels Labels (without braces), e.g. function="move"
+         */
+        void write(std::ostream &os, const std::string &name, const std::string &labels) const {
+
+            auto &b = bucketBounds();
+
+            uint64_t cum = 0;
+            for (size_t i = 0; i < N_BUCKETS; ++i) {
+                cum += _counts[i].load(std::memory_order_relaxed);
+                os << name << "_bucket{" << labels << ",le=\"" << b[i] << "\"} " << cum << "\n";
+            }
+
+            cum += _counts[N_BUCKETS].load(std::memory_order_relaxed);
+            os << name << "_bucket{" << labels << ",le=\"+Inf\"} " << cum << "\n";
+            os << name << "_sum{" << labels << "} " << sum() << "\n";
+            os << name << "_count{" << labels << "} " << cum << "\n";
+
+        }
+
+    };
+
+
+    /** Struct to store the metrics of a single call */
+    struct Call {
+        std::atomic<uint64_t> calls{0};  /**< the number of calls */
+        std::atomic<uint64_t> errors{0}; /**< the number of failed calls */
+        Histogram latency{};             /**< the latency histogram */
+    };
+
+
+    /**
+     * @brief Metrics of a fixed set of calls
+     * The set of calls is defined on construction, recording is lock-free.
+     */
+    class CallTable {
+
+        std::vector<std::string> _names{};
+        std::unique_ptr<Call[]> _calls{};
+
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+
+        /**
+         * Constructor
+         * @param names Names of the calls
+         */
+        explicit CallTable(std::vector<std::string> names)
+                : _names(std::move(names)), _calls(new Call[_names.size()]) {}
+
+
+        /**
+         * Returns the number of calls
+         * @return Number of calls
+         */
+        size_t size() const {
+
+            return _names.size();
+
+        }
+
+
+        /**
+         * Returns the name of the call
+         * @param i Index of the call
+         * @return Name
+         */
+        const std::string &name(size_t i) const {
+
+            return _names[i];
+
+        }
+
+
+        /**
+         * Returns the metrics of the call
+         * @param i Index of the call
+         * @return Metrics
+         */
+        const Call &at(size_t i) const {
+
+            return _calls[i];
+
+        }
+
+
+        /**
+         * Records a call
+         * @param i Index of the call
+         * @param start Start time of the call
+         * @param error Flag whether the call failed
+         */
+        void record(size_t i, clock::time_point start, bool error) {
+
+            auto &c = _calls[i];
+
+            c.calls.fetch_add(1, std::memory_order_relaxed);
+            if (error)
+                c.errors.fetch_add(1, std::memory_order_relaxed);
+
+            c.latency.observe(std::chrono::duration<double>(clock::now() - start).count());
+
+        }
+
+
+        /**
+         * Writes the calls, errors and latencies in the Prometheus text format
+         * @param os Output stream
+         * @param prefix Prefix of the metric names
+         * @param label Label name of the call
+         */
+        void write(std::ostream &os, const std::string &prefix, const std::string &label) const {
+
+            os << "# HELP " << prefix << "_calls_total Number of calls.\n";
+            os << "# TYPE " << prefix << "_calls_total counter\n";
+            for (size_t i = 0; i < size(); ++i)
+                os << prefix << "_calls_total{" << label << "=\"" << _names[i] << "\"} "
+                   << _calls[i].calls.load(std::memory_order_relaxed) << "\n";
+
+            os << "# HELP " << prefix << "_errors_total Number of failed calls.\n";
+            os << "# TYPE " << prefix << "_errors_total counter\n";
+            for (size_t i = 0; i < size(); ++i)
+                os << prefix << "_errors_total{" << label << "=\"" << _names[i] << "\"} "
+                   << _calls[i].errors.load(std::memory_order_relaxed) << "\n";
+
+            os << "# HELP " << prefix << "_latency_seconds Latency of the calls.\n";
+            os << "# TYPE " << prefix << "_latency_seconds histogram\n";
+            for (size_t i = 0; i < size(); ++i)
+                _calls[i].latency.write(os, prefix + "_latency_seconds", label + "=\"" + _names[i] + "\"");
+
+        }
+
+    };
+
+
+    /**
+     * @brief Lock-free counters indexed by a numeric code
+     * Codes beyond the size are counted in the last counter.
+     */
+    template<size_t N>
+    class CodeCounter {
+
+        std::array<std::atomic<uint64_t>, N> _counts{};
+
+    public:
+
+        CodeCounter() {
+
+            for (auto &c : _counts)
+                c.store(0, std::memory_order_relaxed);
+
+        }
+
+
+        /**
+         * Increments the counter of the given code
+         * @param code Code
+         */
+        void increment(size_t code) {
+
+            _counts[std::min(code, N - 1)].fetch_add(1, std::memory_order_relaxed);
+
+        }
+
+
+        /**
+         * Writes all non-zero counters in the Prometheus text format
+         * @param os Output stream
+         * @param name Metric name
+         * @param label Label name of the code
+         */
+        void write(std::ostream &os, const std::string &name, const std::string &label) const {
+
+            os << "# HELP " << name << " Number of occurrences per code.\n";
+            os << "# TYPE " << name << " counter\n";
+
+            for (size_t i = 0; i < N; ++i) {
+
+                auto n = _counts[i].load(std::memory_order_relaxed);
+                if (n != 0)
+                    os << name << "{" << label << "=\"" << i << "\"} " << n << "\n";
+
+            }
+
+        }
+
+    };
+
+
+}}
+
+#endif // SIMMAP_BASE_METRICS_H
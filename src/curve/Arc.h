@@ -118,6 +118,46 @@ namespace curve {
         }
 
 
+        /**
+         * Projects the given point on the arc (closed form by the angle around the center of the arc)
+         * @param point Point to be projected
+         * @param d Offset (will be updated)
+         * @return Position
+         */
+        double project(const base::Vector3 &point, double &d) const override {
+
+            // get start position
+            base::CurvePoint pos0(startPoint());
+
+            // point relative to the center
+            double dx = point.x - pos0.position.x + sin(pos0.angle) / _crv;
+            double dy = point.y - pos0.position.y - cos(pos0.angle) / _crv;
+
+            // angle of the foot point and angle travelled from the start (in driving direction)
+            double phi = atan2(_crv * dx, -_crv * dy);
+            double dPhi = std::fmod(std::copysign(1.0, _crv) * (phi - pos0.angle), 2.0 * M_PI);
+            if (dPhi < 0.0)
+                dPhi += 2.0 * M_PI;
+
+            double s = dPhi / std::abs(_crv);
+
+            // inside the arc: offset is the difference of the radii
+            if (s <= length()) {
+                d = 1.0 / _crv - std::copysign(1.0, _crv) * sqrt(dx * dx + dy * dy);
+                return s;
+            }
+
+            // outside the arc: take the closer end
+            s = (s - length() < 2.0 * M_PI / std::abs(_crv) - s) ? length() : 0.0;
+
+            auto p = pos(s);
+            d = -(point.x - p.position.x) * sin(p.angle) + (point.y - p.position.y) * cos(p.angle);
+
+            return s;
+
+        }
+
+
     };
 
 
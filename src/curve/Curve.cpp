@@ -26,14 +26,234 @@
 #include "Line.h"
 #include "Arc.h"
 #include "Spiral.h"
+#include "Poly3.h"
 
 #include <base/functions.h>
+#include <algorithm>
 #include <cmath>
 
 namespace simmap {
 namespace curve {
 
 
+    /**
+     * Interpolates the curve between two points by cubic Hermite splines
+     * @param s0 Position of the first point
+     * @param p0 First point
+     * @param s1 Position of the second point
+     * @param p1 Second point
+     * @param s Position to be interpolated
+     * @return Interpolated curve point
+     */
+    base::CurvePoint hermite(double s0, const base::CurvePoint &p0, double s1, const base::CurvePoint &p1, double s) {
+
+        double h = s1 - s0;
+        double t = (s - s0) / h;
+        double t2 = t * t;
+        double t3 = t2 * t;
+
+        // basis functions
+        double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+        double h10 = t3 - 2.0 * t2 + t;
+        double h01 = -2.0 * t3 + 3.0 * t2;
+        double h11 = t3 - t2;
+
+        // unwrap the end angle
+        double phi1 = p0.angle + base::angleDiff(p1.angle, p0.angle);
+
+        return {base::Vector3{
+                        h00 * p0.position.x + h10 * h * cos(p0.angle) + h01 * p1.position.x + h11 * h * cos(phi1),
+                        h00 * p0.position.y + h10 * h * sin(p0.angle) + h01 * p1.position.y + h11 * h * sin(phi1),
+                        0.0},
+                h00 * p0.angle + h10 * h * p0.curvature + h01 * phi1 + h11 * h * p1.curvature,
+                p0.curvature + t * (p1.curvature - p0.curvature)};
+
+    }
+
+
+
+    /**
+     * Copies the parameters of the given element into the contiguous storage type
+     * @param s0 Start position of the element in the curve
+     * @param element Element
+     * @return Packed element
+     */
+    Curve::Packed packElement(double s0, const GeoElement *element) {
+
+        Curve::Packed p{};
+        p.type = element->type();
+        p.s0 = s0;
+        p.start = element->startPoint();
+
+        // copy parameters
+        switch (p.type) {
+
+            case GeoElement::Type::LINE:
+                p.line.cos = cos(p.start.angle);
+                p.line.sin = sin(p.start.angle);
+                break;
+
+            case GeoElement::Type::ARC:
+                p.arc.kappa = p.start.curvature;
+                p.arc.x0 = sin(p.start.angle);
+                p.arc.y0 = 1.0 - cos(p.start.angle);
+                break;
+
+            case GeoElement::Type::SPIRAL: {
+
+                auto &q = p.spiral;
+                q.kappa0 = p.start.curvature;
+                q.sigma = dynamic_cast<const Spiral *>(element)->curvatureDerivative();
+
+                Spiral::standard(q.kappa0 / q.sigma, q.sigma, q.x0, q.y0, q.tau0);
+                q.cos = cos(p.start.angle - q.tau0);
+                q.sin = sin(p.start.angle - q.tau0);
+                break;
+
+            }
+
+            case GeoElement::Type::PARAM_POLY_3: {
+
+                auto &q = p.poly3;
+                auto poly = dynamic_cast<const Poly3 *>(element);
+
+                std::copy(poly->coefficientsX(), poly->coefficientsX() + 4, q.cx);
+                std::copy(poly->coefficientsY(), poly->coefficientsY() + 4, q.cy);
+                q.scale = poly->scale();
+                q.cos = cos(p.start.angle);
+                q.sin = sin(p.start.angle);
+                q.arc = poly->arcTable();
+                break;
+
+            }
+
+            default:
+                p.element = element;
+
+        }
+
+        return p;
+
+    }
+
+
+    /**
+     * Evaluates the packed element at the given positions until the end of the element is reached. The type is
+     * switched once, the positions are evaluated in a tight loop
+     * @param e Packed element
+     * @param s1 End position of the element in the curve (positions before the end are evaluated)
+     * @param s Positions in the curve (sorted)
+     * @param n Number of positions
+     * @param x x coordinates (will be updated)
+     * @param y y coordinates (will be updated)
+     * @param phi Headings (will be updated)
+     * @param kappa Curvatures (will be updated)
+     * @return Number of evaluated positions
+     */
+    size_t evaluate(const Curve::Packed &e, double s1, const double *s, size_t n, double *x, double *y, double *phi,
+                    double *kappa) {
+
+        // get number of positions in the element
+        size_t m = 0;
+        while (m < n && s[m] < s1)
+            ++m;
+
+        const auto &r0 = e.start.position;
+        switch (e.type) {
+
+            case GeoElement::Type::LINE:
+
+                for (size_t i = 0; i < m; ++i) {
+
+                    auto ds = s[i] - e.s0;
+
+                    x[i] = e.line.cos * ds + r0.x;
+                    y[i] = e.line.sin * ds + r0.y;
+                    phi[i] = e.start.angle;
+                    kappa[i] = 0.0;
+
+                }
+
+                break;
+
+            case GeoElement::Type::ARC:
+
+                for (size_t i = 0; i < m; ++i) {
+
+                    auto p = e.start.angle + (s[i] - e.s0) * e.arc.kappa;
+
+                    x[i] = (sin(p) - e.arc.x0) / e.arc.kappa + r0.x;
+                    y[i] = (1.0 - cos(p) - e.arc.y0) / e.arc.kappa + r0.y;
+                    phi[i] = p;
+                    kappa[i] = e.arc.kappa;
+
+                }
+
+                break;
+
+            case GeoElement::Type::SPIRAL:
+
+                for (size_t i = 0; i < m; ++i) {
+
+                    const auto &q = e.spiral;
+
+                    // calculate end of the standard spiral and translate to origin
+                    double k = q.kappa0 + (s[i] - e.s0) * q.sigma;
+                    double x1, y1, tau1;
+                    Spiral::standard(k / q.sigma, q.sigma, x1, y1, tau1);
+
+                    x1 = x1 - q.x0;
+                    y1 = y1 - q.y0;
+
+                    x[i] = q.cos * x1 - q.sin * y1 + r0.x;
+                    y[i] = q.sin * x1 + q.cos * y1 + r0.y;
+                    phi[i] = tau1 + e.start.angle - q.tau0;
+                    kappa[i] = k;
+
+                }
+
+                break;
+
+            case GeoElement::Type::PARAM_POLY_3:
+
+                for (size_t i = 0; i < m; ++i) {
+
+                    const auto &q = e.poly3;
+
+                    // evaluate the polynomial at the parameter of the arc length and rotate
+                    double r[2], d[2], dd[2];
+                    Poly3::evaluate(q.cx, q.cy, Poly3::parameter(q.cx, q.cy, q.arc, (s[i] - e.s0) * q.scale), r, d, dd);
+
+                    x[i] = r[0] * q.cos - r[1] * q.sin + r0.x;
+                    y[i] = r[0] * q.sin + r[1] * q.cos + r0.y;
+                    phi[i] = e.start.angle + atan2(d[1], d[0]);
+                    kappa[i] = Poly3::curvature(d, dd);
+
+                }
+
+                break;
+
+            default:
+
+                for (size_t i = 0; i < m; ++i) {
+
+                    auto p = e.element->pos(s[i] - e.s0);
+
+                    x[i] = p.position.x;
+                    y[i] = p.position.y;
+                    phi[i] = p.angle;
+                    kappa[i] = p.curvature;
+
+                }
+
+        }
+
+        return m;
+
+    }
+
+
+
     GeoElement::Type Curve::type() const {
 
         return GeoElement::Type::CURVE;
@@ -68,6 +288,12 @@ namespace curve {
 
         }
 
+        // update contiguous storage and samples
+        if (!_packed.empty())
+            pack();
+
+        if (baked())
+            bake(_tolerance);
 
     }
 
@@ -96,6 +322,31 @@ namespace curve {
 
     double Curve::curvature(double s) const {
 
+        // evaluate contiguous storage
+        if (!_packed.empty()) {
+
+            const auto &e = _element(s);
+            s -= e.s0;
+
+            switch (e.type) {
+                case GeoElement::Type::LINE:
+                    return 0.0;
+                case GeoElement::Type::ARC:
+                    return e.arc.kappa;
+                case GeoElement::Type::SPIRAL:
+                    return e.spiral.kappa0 + s * e.spiral.sigma;
+                case GeoElement::Type::PARAM_POLY_3: {
+                    const auto &q = e.poly3;
+                    double r[2], d[2], dd[2];
+                    Poly3::evaluate(q.cx, q.cy, Poly3::parameter(q.cx, q.cy, q.arc, s * q.scale), r, d, dd);
+                    return Poly3::curvature(d, dd);
+                }
+                default:
+                    return e.element->curvature(s);
+            }
+
+        }
+
         auto e = atPos(s);
         return e.element->curvature(e.position);
 
@@ -149,6 +400,31 @@ namespace curve {
 
     base::CurvePoint Curve::pos(double s) const {
 
+        // interpolate baked curve
+        if (!_s.empty()) {
+
+            if (s > _s.back() || s < _s.front())
+                throw std::invalid_argument("s is out of range");
+
+            // get interval
+            auto i = static_cast<size_t>(std::upper_bound(_s.begin(), _s.end(), s) - _s.begin());
+            i = std::min(_s.size() - 1, std::max<size_t>(1, i)) - 1;
+
+            return hermite(_s[i], {{_x[i], _y[i], 0.0}, _phi[i], _kappa[i]},
+                           _s[i + 1], {{_x[i + 1], _y[i + 1], 0.0}, _phi[i + 1], _kappa[i + 1]}, s);
+
+        }
+
+        // evaluate contiguous storage
+        if (!_packed.empty()) {
+
+            base::CurvePoint p{};
+            evaluate(_element(s), INFINITY, &s, 1, &p.position.x, &p.position.y, &p.angle, &p.curvature);
+
+            return p;
+
+        }
+
         // get position
         auto e = atPos(s);
         return e.element->pos(e.position);
@@ -156,6 +432,265 @@ namespace curve {
     }
 
 
+    void Curve::pack() {
+
+        _packed.clear();
+        _packed.reserve(size());
+
+        for (const auto &e : *this)
+            _packed.push_back(packElement(e.position, e.element));
+
+    }
+
+
+    void Curve::pos(const double *s, size_t n, double *x, double *y, double *phi, double *kappa) const {
+
+        if (n == 0)
+            return;
+
+        if (s[0] < startPosition() || s[n - 1] > endPosition())
+            throw std::invalid_argument("s is out of range");
+
+        // interpolate baked curve
+        if (!_s.empty()) {
+
+            size_t j = 0;
+            for (size_t i = 0; i < n; ++i) {
+
+                // move to interval
+                while (j + 2 < _s.size() && s[i] >= _s[j + 1])
+                    ++j;
+
+                auto p = hermite(_s[j], {{_x[j], _y[j], 0.0}, _phi[j], _kappa[j]},
+                                 _s[j + 1], {{_x[j + 1], _y[j + 1], 0.0}, _phi[j + 1], _kappa[j + 1]}, s[i]);
+
+                x[i] = p.position.x;
+                y[i] = p.position.y;
+                phi[i] = p.angle;
+                kappa[i] = p.curvature;
+
+            }
+
+            return;
+
+        }
+
+        // walk the elements once
+        size_t i = 0;
+        if (!_packed.empty()) {
+
+            for (size_t k = 0; k < _packed.size() && i < n; ++k) {
+
+                auto s1 = k + 1 < _packed.size() ? _packed[k + 1].s0 : INFINITY;
+                i += evaluate(_packed[k], s1, s + i, n - i, x + i, y + i, phi + i, kappa + i);
+
+            }
+
+        } else {
+
+            auto k = size();
+            for (const auto &e : *this) {
+
+                if (i == n)
+                    break;
+
+                auto s1 = --k == 0 ? INFINITY : e.position + e.length;
+                i += evaluate(packElement(e.position, e.element), s1, s + i, n - i, x + i, y + i, phi + i, kappa + i);
+
+            }
+
+        }
+
+    }
+
+
+    bool Curve::packed() const {
+
+        return !_packed.empty();
+
+    }
+
+
+    const Curve::Packed &Curve::_element(double s) const {
+
+        if (s > endPosition() || s < startPosition())
+            throw std::invalid_argument("s is out of range");
+
+        // find element
+        auto it = std::upper_bound(_packed.begin(), _packed.end(), s,
+                                   [](double v, const Packed &p) { return v < p.s0; });
+
+        if (it != _packed.begin())
+            --it;
+
+        return *it;
+
+    }
+
+
+    void Curve::bake(double tolerance) {
+
+        _s.clear();
+        _x.clear();
+        _y.clear();
+        _phi.clear();
+        _kappa.clear();
+
+        _tolerance = tolerance;
+        if (tolerance <= 0.0 || empty())
+            return;
+
+        // sample elements separately
+        for (const auto &e : *this) {
+
+            if (e.length <= 0.0)
+                continue;
+
+            auto p0 = e.element->pos(0.0);
+            auto p1 = e.element->pos(e.length);
+
+            // start point of the element (the end point of the previous element is kept, the lookup of a position at
+            // the border returns the interval of the element, the interval in between has zero length)
+            _addSample(e.position, p0);
+
+            _bake(e.element, e.position, 0.0, p0, e.length, p1, tolerance);
+
+        }
+
+    }
+
+
+    bool Curve::baked() const {
+
+        return !_s.empty();
+
+    }
+
+
+    void Curve::_addSample(double s, const base::CurvePoint &p) {
+
+        // unwrap angle
+        auto phi = _phi.empty() ? p.angle : _phi.back() + base::angleDiff(p.angle, _phi.back());
+
+        _s.push_back(s);
+        _x.push_back(p.position.x);
+        _y.push_back(p.position.y);
+        _phi.push_back(phi);
+        _kappa.push_back(p.curvature);
+
+    }
+
+
+    void Curve::_bake(const GeoElement *element, double offset, double s0, const base::CurvePoint &p0, double s1,
+                      const base::CurvePoint &p1, double tolerance) {
+
+        // check deviation of position and angle at the quarters
+        bool split = false;
+        if (s1 - s0 > 2.0 * CURVE_BAKE_MIN_STEP) {
+
+            for (double f : {0.25, 0.5, 0.75}) {
+
+                auto s = s0 + f * (s1 - s0);
+                auto p = element->pos(s);
+                auto q = hermite(s0, p0, s1, p1, s);
+
+                auto dx = p.position.x - q.position.x;
+                auto dy = p.position.y - q.position.y;
+
+                if (dx * dx + dy * dy > tolerance * tolerance
+                    || std::abs(base::angleDiff(p.angle, q.angle)) > tolerance) {
+                    split = true;
+                    break;
+                }
+
+            }
+
+        }
+
+        // add end point, if interpolation is accurate enough
+        if (!split) {
+            _addSample(offset + s1, p1);
+            return;
+        }
+
+        // split interval
+        auto sm = 0.5 * (s0 + s1);
+        auto pm = element->pos(sm);
+
+        _bake(element, offset, s0, p0, sm, pm, tolerance);
+        _bake(element, offset, sm, pm, s1, p1, tolerance);
+
+    }
+
+
+    double Curve::project(const base::Vector3 &point, double &d) const {
+
+        double s = startPosition();
+        double err = INFINITY;
+
+        // project on all elements and take the closest foot point
+        for (const auto &e : *this) {
+
+            double de = 0.0;
+            auto se = e.element->project(point, de);
+
+            auto p = e.element->position(se, de);
+            auto dx = point.x - p.position.x;
+            auto dy = point.y - p.position.y;
+            auto ee = dx * dx + dy * dy + de * de;
+
+            if (ee < err) {
+                err = ee;
+                s = e.position + se;
+                d = de;
+            }
+
+        }
+
+        return s;
+
+    }
+
+
+    double Curve::project(const base::Vector3 &point, double &d, double s) const {
+
+        // find element at the given position
+        auto it = begin();
+        for (auto itn = std::next(begin()); itn != end() && (*itn).position <= s; ++itn)
+            ++it;
+
+        int dir = 0;
+        for (size_t i = 0; i < size(); ++i) {
+
+            auto e = *it;
+            auto se = e.element->project(point, d);
+            s = e.position + se;
+
+            // move to the neighbored element, when the foot point is at the border of the element
+            auto next = std::next(it);
+            int nd = 0;
+            if (se < base::EPS_DISTANCE && it != begin())
+                nd = -1;
+            else if (se > e.length - base::EPS_DISTANCE && next != end())
+                nd = 1;
+
+            // stop if the foot point is inside or the direction changes
+            if (nd == 0 || nd == -dir)
+                break;
+
+            dir = nd;
+            if (dir > 0)
+                ++it;
+            else
+                --it;
+
+        }
+
+        return s;
+
+    }
+
+
     double Curve::length() const {
 
         return GeoElement::length();
@@ -168,6 +703,13 @@ namespace curve {
         sequence::length(len);
         GeoElement::length(len);
 
+        // update contiguous storage and samples
+        if (!_packed.empty())
+            pack();
+
+        if (baked())
+            bake(_tolerance);
+
     }
 
 }}
@@ -27,9 +27,14 @@
 
 
 #include "GeoElement.h"
+#include <vector>
 #include <base/sequence.h>
 #include <base/definitions.h>
 
+#ifndef CURVE_BAKE_MIN_STEP
+#define CURVE_BAKE_MIN_STEP 0.1 // minimum distance between the sample points of a baked curve
+#endif
+
 
 namespace simmap {
 namespace curve {
@@ -38,10 +43,48 @@ namespace curve {
 class Curve : public GeoElement, public base::sequence<GeoElement*>
 {
 
+public:
+
+    /** Struct to define a geo element in the contiguous storage, the parameters are stored in a tagged union */
+    struct Packed {
+        GeoElement::Type type = GeoElement::Type::LINE;  /**< the type of the element (tag of the union) */
+        double s0 = 0.0;                                  /**< the start position of the element in the curve */
+        base::CurvePoint start{};                         /**< the start point of the element */
+        union {
+            struct { double cos, sin; } line;             /**< the direction of the line */
+            struct { double kappa, x0, y0; } arc;         /**< the curvature and the start terms of the arc */
+            struct {
+                double kappa0, sigma, x0, y0, tau0, cos, sin;
+            } spiral;                                     /**< the curvature and the cached terms of the spiral */
+            struct {
+                double cx[4], cy[4], scale, cos, sin;
+                const double *arc;
+            } poly3;                                      /**< the cached terms of the polynomial */
+            const GeoElement *element;                    /**< the element (other types are evaluated virtually) */
+        };
+    };
+
+
 private:
 
+    // geo elements in contiguous storage (empty when not packed)
+    std::vector<Packed> _packed{};
+
+    // sample points of the baked curve (empty when evaluated exactly)
+    std::vector<double> _s{};
+    std::vector<double> _x{};
+    std::vector<double> _y{};
+    std::vector<double> _phi{};
+    std::vector<double> _kappa{};
+    double _tolerance = 0.0;
+
+
 
     void _addElement(double s, double ds, double kappa0, double kappa1);
+    const Packed &_element(double s) const;
+    void _addSample(double s, const base::CurvePoint &p);
+    void _bake(const GeoElement *element, double offset, double s0, const base::CurvePoint &p0, double s1,
+               const base::CurvePoint &p1, double tolerance);
 
 
 public:
@@ -66,6 +109,53 @@ public:
     void length(double len) override;
     base::CurvePoint pos(double s) const override;
 
+    /**
+     * Copies the parameters of the elements into a contiguous storage. Lines, arcs and spirals are evaluated from the
+     * storage by a switch on the element type afterwards, which avoids the pointer chase and the virtual calls. The
+     * results are identical to the evaluation of the elements. The storage is updated when the start point or the
+     * length of the curve is set
+     */
+    void pack();
+
+    /**
+     * Evaluates the curve at the given positions, which have to be sorted in ascending order. The elements are walked
+     * once and the results are written into separate arrays
+     * @param s Positions (sorted)
+     * @param n Number of positions
+     * @param x x coordinates, an array of n entries (will be updated)
+     * @param y y coordinates, an array of n entries (will be updated)
+     * @param phi Headings, an array of n entries (will be updated)
+     * @param kappa Curvatures, an array of n entries (will be updated)
+     */
+    void pos(const double *s, size_t n, double *x, double *y, double *phi, double *kappa) const;
+
+    /**
+     * Returns whether the curve is packed
+     * @return Flag
+     */
+    bool packed() const;
+
+    /**
+     * Samples the curve adaptively and evaluates the curve by cubic Hermite interpolation between the sample points
+     * afterwards (position with the heading as tangent, heading with the curvature as derivative, curvature linear).
+     * The sample points are added until the interpolated position (in m) and heading (in rad) deviate less than the
+     * tolerance from the exact values. The element borders are sampled twice (with the end point of the previous and
+     * the start point of the next element), since the curvature may jump. A tolerance of zero switches back to the
+     * exact evaluation. The curve is baked again when the start point or the length is changed, after other
+     * modifications it has to be baked again explicitly
+     * @param tolerance Tolerance
+     */
+    void bake(double tolerance);
+
+    /**
+     * Returns whether the curve is baked
+     * @return Flag
+     */
+    bool baked() const;
+
+    double project(const base::Vector3 &point, double &d) const override;
+    double project(const base::Vector3 &point, double &d, double s) const;
+
 };
 
 }} // namespace ::simmap::server
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2019 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-10.
+//
+
+#ifndef SIMMAP_CURVE_FRESNEL_H
+#define SIMMAP_CURVE_FRESNEL_H
+
+#include <cmath>
+
+#ifndef FRESNEL_SERIES_LIMIT
+#define FRESNEL_SERIES_LIMIT 1.0 // maximum argument for which the power series of the Fresnel integrals is used
+#endif
+
+namespace simmap {
+namespace curve {
+
+
+    /**
+     * Calculates the Fresnel integrals S(x) = int_0^x sin(pi/2 t^2) dt and C(x) = int_0^x cos(pi/2 t^2) dt by their
+     * power series in w = x^4 (Horner scheme), without any division or trigonometric function. For |x| <= 1 the
+     * series is alternating with decreasing terms, so the truncation error is below the first omitted term (4e-19 for
+     * C, 6e-18 for S), the remaining error is due to rounding (the difference to odrSpiral is below 4e-16). The
+     * function does not calculate anything for larger arguments
+     * @param x Argument
+     * @param s Fresnel integral S(x) (will be updated)
+     * @param c Fresnel integral C(x) (will be updated)
+     * @return Flag whether the argument is within the range of the series (|x| <= FRESNEL_SERIES_LIMIT)
+     */
+    inline bool fresnelSeries(double x, double &s, double &c) {
+
+        static const double cc[] = {
+            1.0,
+            -0.24674011002723395,
+            0.028185500877894218,
+            -0.001604883135642535,
+            5.4074133814083896e-05,
+            -1.2000972558600284e-06,
+            1.8843499115272676e-08,
+            -2.2022769254454653e-10,
+            1.9896857924180207e-12,
+            -1.430918973171519e-14,
+            8.384729705118548e-17
+        };
+
+        static const double sc[] = {
+            0.5235987755982988,
+            -0.09228058535803517,
+            0.007244784204197003,
+            -0.0003121169423545791,
+            8.444272883545251e-06,
+            -1.5647144500922104e-07,
+            2.1082121933214533e-09,
+            -2.157430680584343e-11,
+            1.7334102088874836e-13,
+            -1.1223244787983947e-15
+        };
+
+        if (std::abs(x) > FRESNEL_SERIES_LIMIT)
+            return false;
+
+        auto x2 = x * x;
+        auto w = x2 * x2;
+
+        // evaluate polynomials
+        double pc = cc[10];
+        for (int i = 9; i >= 0; --i)
+            pc = pc * w + cc[i];
+
+        double ps = sc[9];
+        for (int i = 8; i >= 0; --i)
+            ps = ps * w + sc[i];
+
+        c = x * pc;
+        s = x * x2 * ps;
+
+        return true;
+
+    }
+
+}} // namespace ::simmap::curve
+
+#endif // SIMMAP_CURVE_FRESNEL_H
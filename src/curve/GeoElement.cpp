@@ -96,4 +96,46 @@ namespace curve {
     }
 
 
+    double GeoElement::project(const base::Vector3 &point, double &d) const {
+
+        auto p = startPoint();
+        auto l = length();
+
+        // start with the projection on the start tangent
+        auto s = (point.x - p.position.x) * cos(p.angle) + (point.y - p.position.y) * sin(p.angle);
+        s = std::max(0.0, std::min(l, s));
+
+        for (int i = 0; i < GEO_PROJECT_ITERATIONS; ++i) {
+
+            p = pos(s);
+
+            // local coordinates of the point
+            auto dx = point.x - p.position.x;
+            auto dy = point.y - p.position.y;
+            auto u = dx * cos(p.angle) + dy * sin(p.angle);
+            auto v = -dx * sin(p.angle) + dy * cos(p.angle);
+
+            // derivative of u (fall back to a simple step near the center of curvature)
+            auto du = 1.0 - p.curvature * v;
+            if (du < 0.1)
+                du = 1.0;
+
+            auto sn = std::max(0.0, std::min(l, s + u / du));
+            auto done = std::abs(sn - s) < base::EPS_DISTANCE;
+            s = sn;
+
+            if (done)
+                break;
+
+        }
+
+        // calculate offset
+        p = pos(s);
+        d = -(point.x - p.position.x) * sin(p.angle) + (point.y - p.position.y) * cos(p.angle);
+
+        return s;
+
+    }
+
+
 }}
\ No newline at end of file
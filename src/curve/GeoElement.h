@@ -28,6 +28,10 @@
 #include <vector>
 #include <base/definitions.h>
 
+#ifndef GEO_PROJECT_ITERATIONS
+#define GEO_PROJECT_ITERATIONS 8 // maximum number of Newton iterations to project a point on a geo element
+#endif
+
 namespace simmap {
 namespace curve {
 
@@ -151,6 +155,18 @@ namespace curve {
          */
         base::CurvePoint position(double s, double d) const;
 
+
+        /**
+         * Projects the given point on the geo element, i.e. calculates the position and the offset of the foot point.
+         * The position is limited to the element, the offset is measured perpendicular to the curve at the position
+         * (left is positive). The default implementation applies Newton's method on the arc length by using the
+         * curvature as analytic derivative
+         * @param point Point to be projected (z is ignored)
+         * @param d Offset (will be updated)
+         * @return Position
+         */
+        virtual double project(const base::Vector3 &point, double &d) const;
+
     };
 
 }} // namespace ::simmap::server
@@ -25,6 +25,7 @@
 #ifndef SIMMAP_CURVE_LINE_H
 #define SIMMAP_CURVE_LINE_H
 
+#include <algorithm>
 #include <base/functions.h>
 #include "GeoElement.h"
 
@@ -106,6 +107,25 @@ namespace curve {
         }
 
 
+        /**
+         * Projects the given point on the line (closed form)
+         * @param point Point to be projected
+         * @param d Offset (will be updated)
+         * @return Position
+         */
+        double project(const base::Vector3 &point, double &d) const override {
+
+            base::CurvePoint pos(startPoint());
+
+            auto dx = point.x - pos.position.x;
+            auto dy = point.y - pos.position.y;
+
+            d = -dx * sin(pos.angle) + dy * cos(pos.angle);
+            return std::max(0.0, std::min(length(), dx * cos(pos.angle) + dy * sin(pos.angle)));
+
+        }
+
+
     };
 
 }
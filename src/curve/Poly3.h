@@ -26,9 +26,14 @@
 #define SIMMAP_CURVE_POLY3_H
 
 #include "GeoElement.h"
+#include <algorithm>
 #include <base/poly1.h>
 #include <base/functions.h>
 
+#ifndef POLY3_TABLE_SIZE
+#define POLY3_TABLE_SIZE 32 // number of intervals of the arc length table of a polynomial
+#endif
+
 namespace simmap {
 namespace curve {
 
@@ -46,10 +51,173 @@ namespace curve {
         base::poly1 polyX{};
         base::poly1 polyY{};
 
+        // coefficients in ascending order
+        double _cx[4] = {0.0, 0.0, 0.0, 0.0};
+        double _cy[4] = {0.0, 0.0, 0.0, 0.0};
+
+        // arc length at equidistant parameters
+        double _arc[POLY3_TABLE_SIZE + 1] = {};
+
+
+        /**
+         * Evaluates the polynomials of the element (see static evaluate)
+         */
+        void evaluate(double t, double *r, double *d, double *dd) const {
+
+            evaluate(_cx, _cy, t, r, d, dd);
+
+        }
+
+
+        /**
+         * Returns the speed of the element (see static speed)
+         */
+        double speed(double t) const {
+
+            return speed(_cx, _cy, t);
+
+        }
+
+
+        /**
+         * Updates the coefficients and the arc length table (Gauss-Legendre quadrature in each interval)
+         */
+        void update() {
+
+            for (size_t i = 0; i < 4; ++i) {
+                _cx[i] = polyX[3 - i];
+                _cy[i] = polyY[3 - i];
+            }
+
+            const double x[5] = {-0.906179845938664, -0.538469310105683, 0.0, 0.538469310105683, 0.906179845938664};
+            const double w[5] = {0.236926885056189, 0.478628670499366, 0.568888888888889, 0.478628670499366,
+                                 0.236926885056189};
+
+            const double h = 1.0 / POLY3_TABLE_SIZE;
+
+            _arc[0] = 0.0;
+            for (size_t i = 0; i < POLY3_TABLE_SIZE; ++i) {
+
+                double sum = 0.0;
+                for (size_t j = 0; j < 5; ++j)
+                    sum += w[j] * speed(h * (i + 0.5 + 0.5 * x[j]));
+
+                _arc[i + 1] = _arc[i] + 0.5 * h * sum;
+
+            }
+
+        }
+
+
+        /**
+         * Interpolates cubically between the given values by using the derivatives
+         * @param x0 Start position
+         * @param y0 Start value
+         * @param d0 Start derivative
+         * @param x1 End position
+         * @param y1 End value
+         * @param d1 End derivative
+         * @param x Position
+         * @return Value
+         */
+        static double hermite(double x0, double y0, double d0, double x1, double y1, double d1, double x) {
+
+            double h = x1 - x0;
+            double t = h < base::EPS_DISTANCE ? 0.0 : (x - x0) / h;
+
+            return (2.0 * t * t * t - 3.0 * t * t + 1.0) * y0 + (t * t * t - 2.0 * t * t + t) * h * d0
+                   + (-2.0 * t * t * t + 3.0 * t * t) * y1 + (t * t * t - t * t) * h * d1;
+
+        }
+
 
     public:
 
 
+        /**
+         * Evaluates the polynomials and the first and second derivatives at the given parameter
+         * @param cx Coefficients of the x polynomial (ascending order)
+         * @param cy Coefficients of the y polynomial (ascending order)
+         * @param t Parameter
+         * @param r Values (x, y)
+         * @param d First derivatives (x, y)
+         * @param dd Second derivatives (x, y)
+         */
+        static void evaluate(const double *cx, const double *cy, double t, double *r, double *d, double *dd) {
+
+            r[0] = cx[0] + t * (cx[1] + t * (cx[2] + t * cx[3]));
+            r[1] = cy[0] + t * (cy[1] + t * (cy[2] + t * cy[3]));
+            d[0] = cx[1] + t * (2.0 * cx[2] + 3.0 * t * cx[3]);
+            d[1] = cy[1] + t * (2.0 * cy[2] + 3.0 * t * cy[3]);
+            dd[0] = 2.0 * cx[2] + 6.0 * t * cx[3];
+            dd[1] = 2.0 * cy[2] + 6.0 * t * cy[3];
+
+        }
+
+
+        /**
+         * Returns the derivative of the arc length by the parameter
+         * @param cx Coefficients of the x polynomial (ascending order)
+         * @param cy Coefficients of the y polynomial (ascending order)
+         * @param t Parameter
+         * @return Derivative
+         */
+        static double speed(const double *cx, const double *cy, double t) {
+
+            double r[2], d[2], dd[2];
+            evaluate(cx, cy, t, r, d, dd);
+
+            return sqrt(d[0] * d[0] + d[1] * d[1]);
+
+        }
+
+
+        /**
+         * Returns the curvature from the first and second derivatives
+         * @param d First derivatives (x, y)
+         * @param dd Second derivatives (x, y)
+         * @return Curvature
+         */
+        static double curvature(const double *d, const double *dd) {
+
+            return (d[0] * dd[1] - d[1] * dd[0]) / std::max(base::EPS_DISTANCE, pow(d[0] * d[0] + d[1] * d[1], 1.5));
+
+        }
+
+
+        /**
+         * Returns the polynomial parameter at the given arc length. The parameter is interpolated from the arc length
+         * table (the derivatives of the parameter are the inverse speeds)
+         * @param cx Coefficients of the x polynomial (ascending order)
+         * @param cy Coefficients of the y polynomial (ascending order)
+         * @param arc Arc length table
+         * @param a Arc length
+         * @return Parameter
+         */
+        static double parameter(const double *cx, const double *cy, const double *arc, double a) {
+
+            const double h = 1.0 / POLY3_TABLE_SIZE;
+
+            // get interval
+            a = std::max(0.0, std::min(arc[POLY3_TABLE_SIZE], a));
+            auto i = std::upper_bound(arc, arc + POLY3_TABLE_SIZE + 1, a) - arc - 1;
+            i = std::max<long>(0, std::min<long>(POLY3_TABLE_SIZE - 1, i));
+
+            double t0 = h * i;
+            double t1 = h * (i + 1);
+            double v0 = speed(cx, cy, t0);
+            double v1 = speed(cx, cy, t1);
+
+            // fall back to secant at cusps
+            double sec = h / std::max(base::EPS_DISTANCE, arc[i + 1] - arc[i]);
+            double d0 = v0 < base::EPS_DISTANCE ? sec : 1.0 / v0;
+            double d1 = v1 < base::EPS_DISTANCE ? sec : 1.0 / v1;
+
+            return hermite(arc[i], t0, d0, arc[i + 1], t1, d1, a);
+
+        }
+
+
         Poly3() = default;
 
 
@@ -57,8 +225,9 @@ namespace curve {
                 : polyX(base::poly1(ax[0], ax[1], ax[2], ax[3])),
                   polyY(base::poly1(ay[0], ay[1], ay[2], ay[3])) {
 
-            // set length
+            // set length and create arc length table
             GeoElement::length(len);
+            update();
 
         }
 
@@ -94,37 +263,157 @@ namespace curve {
         }
 
 
-        double curvature(double s) const override {
+        /**
+         * Returns the coefficients of the x polynomial in ascending order
+         * @return Coefficients
+         */
+        const double *coefficientsX() const {
 
-            double t = s / length();
+            return _cx;
 
-            base::poly1 derX = polyX.der();
-            base::poly1 derY = polyY.der();
+        }
 
-            double dx = derX(t);
-            double dx2 = derX.der()(t);
 
-            double dy = derY(t);
-            double dy2 = derY.der()(t);
+        /**
+         * Returns the coefficients of the y polynomial in ascending order
+         * @return Coefficients
+         */
+        const double *coefficientsY() const {
 
-            return pow(std::abs(dy2 * dy + dx2 * dx) / (dx * dx + dy * dy), 1.5);
+            return _cy;
 
         }
 
 
-        base::CurvePoint pos(double s) const override {
+        /**
+         * Returns the arc length table (arc length at equidistant parameters)
+         * @return Arc length table
+         */
+        const double *arcTable() const {
+
+            return _arc;
+
+        }
+
+
+        /**
+         * Returns the scale from the position to the arc length of the polynomial (both are equal, if the length of
+         * the element is the arc length)
+         * @return Scale
+         */
+        double scale() const {
+
+            return length() < base::EPS_DISTANCE ? 1.0 : _arc[POLY3_TABLE_SIZE] / length();
+
+        }
+
+
+        /**
+         * Returns the polynomial parameter at the given position
+         * @param s Position
+         * @return Parameter
+         */
+        double parameter(double s) const {
+
+            return parameter(_cx, _cy, _arc, s * scale());
+
+        }
+
 
-            double t = s / length();
+        /**
+         * Returns the position at the given polynomial parameter (inverse of parameter)
+         * @param t Parameter
+         * @return Position
+         */
+        double arcLength(double t) const {
 
-            base::poly1 derX = polyX.der();
-            base::poly1 derY = polyY.der();
+            const double h = 1.0 / POLY3_TABLE_SIZE;
+
+            // get interval
+            t = std::max(0.0, std::min(1.0, t));
+            auto i = std::max<long>(0, std::min<long>(POLY3_TABLE_SIZE - 1, static_cast<long>(t / h)));
+
+            auto a = hermite(h * i, _arc[i], speed(h * i), h * (i + 1), _arc[i + 1], speed(h * (i + 1)), t);
+            return a / scale();
+
+        }
+
+
+        double curvature(double s) const override {
+
+            double r[2], d[2], dd[2];
+            evaluate(parameter(s), r, d, dd);
+
+            return curvature(d, dd);
+
+        }
+
+
+        base::CurvePoint pos(double s) const override {
+
+            double r[2], d[2], dd[2];
+            evaluate(parameter(s), r, d, dd);
 
             // rotate
-            auto pos = base::Vector3{polyX(t), polyY(t), 0.0};
             auto sp = startPoint();
-            pos = base::toGlobal(sp, pos);
+            auto pos = base::toGlobal(sp, base::Vector3{r[0], r[1], 0.0});
+
+            return {pos, sp.angle + atan2(d[1], d[0]), curvature(d, dd)};
+
+        }
+
+
+        /**
+         * Projects the given point on the polynomial (Newton's method on the polynomial parameter with analytic
+         * derivatives)
+         * @param point Point to be projected
+         * @param d Offset (will be updated)
+         * @return Position
+         */
+        double project(const base::Vector3 &point, double &d) const override {
+
+            double r[2], dr[2], ddr[2];
+
+            // transform point into the local coordinate system
+            auto q = base::toLocal(startPoint(), point);
+
+            // start with the projection on the chord
+            double ex = polyX(1.0) - polyX(0.0);
+            double ey = polyY(1.0) - polyY(0.0);
+            double t = ((q.x - polyX(0.0)) * ex + (q.y - polyY(0.0)) * ey)
+                       / std::max(base::EPS_DISTANCE, ex * ex + ey * ey);
+            t = std::max(0.0, std::min(1.0, t));
+
+            for (int i = 0; i < GEO_PROJECT_ITERATIONS; ++i) {
+
+                evaluate(t, r, dr, ddr);
+
+                double rx = r[0] - q.x;
+                double ry = r[1] - q.y;
+                double dx = dr[0];
+                double dy = dr[1];
+
+                // first and second derivative of the squared distance (halved), gradient step if not convex
+                double g = rx * dx + ry * dy;
+                double h = dx * dx + dy * dy + rx * ddr[0] + ry * ddr[1];
+                if (h < 0.1 * (dx * dx + dy * dy))
+                    h = dx * dx + dy * dy;
+
+                auto tn = std::max(0.0, std::min(1.0, t - g / std::max(base::EPS_DISTANCE, h)));
+                auto done = std::abs(tn - t) * length() < base::EPS_DISTANCE;
+                t = tn;
+
+                if (done)
+                    break;
+
+            }
+
+            // calculate offset
+            evaluate(t, r, dr, ddr);
+            d = (-(q.x - r[0]) * dr[1] + (q.y - r[1]) * dr[0])
+                / std::max(base::EPS_DISTANCE, sqrt(dr[0] * dr[0] + dr[1] * dr[1]));
 
-            return {pos, sp.angle + atan2(derY(t), derX(t)), curvature(t)};
+            return arcLength(t);
 
         }
 
@@ -29,6 +29,7 @@ extern "C" {
 
 #include <algorithm>
 #include <base/functions.h>
+#include "Fresnel.h"
 #include "Spiral.h"
 
 namespace simmap {
@@ -36,7 +37,61 @@ namespace curve {
 
     Spiral::Spiral(double len, double c0, double c1) : _kappa0(c0), _kappa1(c1) {
 
-        GeoElement::length(len);
+        Spiral::length(len);
+
+    }
+
+
+    void Spiral::update() {
+
+        // calculate start of the standard spiral
+        auto sigma = curvatureDerivative();
+        standard(_kappa0 / sigma, sigma, _x0, _y0, _tau0);
+
+        // angle to rotate
+        double dPhi = GeoElement::startPoint().angle - _tau0;
+
+        _cos = cos(dPhi);
+        _sin = sin(dPhi);
+
+    }
+
+
+    void Spiral::startPoint(const base::CurvePoint &pos) {
+
+        GeoElement::startPoint(pos);
+        update();
+
+    }
+
+
+    void Spiral::length(double l) {
+
+        GeoElement::length(l);
+        update();
+
+    }
+
+
+    void Spiral::standard(double s, double cDot, double &x, double &y, double &t) {
+
+#if SPIRAL_FAST_FRESNEL
+
+        // use power series for small arguments
+        auto a = sqrt(M_PI / std::abs(cDot));
+        if (fresnelSeries(s / a, y, x)) {
+
+            x *= a;
+            y *= cDot < 0.0 ? -a : a;
+            t = s * s * cDot * 0.5;
+
+            return;
+
+        }
+
+#endif
+
+        odrSpiral(s, cDot, &x, &y, &t);
 
     }
 
@@ -88,33 +143,23 @@ namespace curve {
     base::CurvePoint Spiral::pos(double s) const {
 
         // get start position
-        base::CurvePoint pos0(startPoint());
+        auto pos0 = GeoElement::startPoint();
 
         // calculate end crv
         double kappa1 = curvature(s);
         double sigma  = curvatureDerivative();
 
-        // initialize local results
-        double x0, y0, tau0;
+        // calculate end of spiral (the start is cached)
         double x1, y1, tau1;
-
-        // calculate start and end of spiral
-        odrSpiral(_kappa0 / sigma, sigma, &x0, &y0, &tau0);
-        odrSpiral(kappa1 / sigma, sigma, &x1, &y1, &tau1);
+        standard(kappa1 / sigma, sigma, x1, y1, tau1);
 
         // translate to origin
-        x1 = x1 - x0;
-        y1 = y1 - y0;
-
-        // angle to rotate
-        double dPhi = pos0.angle - tau0;
-
-        // trigonometry
-        double cs = cos(dPhi);
-        double ss = sin(dPhi);
+        x1 = x1 - _x0;
+        y1 = y1 - _y0;
 
         // rotate local position and return position
-        return {base::Vector3{cs * x1 - ss * y1, ss * x1 + cs * y1, 0.0} + pos0.position, tau1 + dPhi, kappa1};
+        return {base::Vector3{_cos * x1 - _sin * y1, _sin * x1 + _cos * y1, 0.0} + pos0.position,
+                tau1 + pos0.angle - _tau0, kappa1};
 
     }
 
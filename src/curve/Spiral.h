@@ -27,6 +27,10 @@
 
 #include "GeoElement.h"
 
+#ifndef SPIRAL_FAST_FRESNEL
+#define SPIRAL_FAST_FRESNEL 1 // use the power series of the Fresnel integrals for small arguments
+#endif
+
 namespace simmap {
 namespace curve {
 
@@ -40,8 +44,24 @@ namespace curve {
         double _kappa0 = 0.0;
         double _kappa1 = 0.0;
 
+        // cached start of the standard spiral and rotation into the global coordinate system
+        double _x0 = 0.0;
+        double _y0 = 0.0;
+        double _tau0 = 0.0;
+        double _cos = 1.0;
+        double _sin = 0.0;
+
+
+        /**
+         * Updates the cached start of the standard spiral and the rotation
+         */
+        void update();
+
     public:
 
+        using GeoElement::startPoint;
+        using GeoElement::length;
+
 
         /**
          * Default constructor
@@ -109,6 +129,35 @@ namespace curve {
 
 
 
+        /**
+         * Sets the start point of the spiral
+         * @param pos Start point
+         */
+        void startPoint(const base::CurvePoint &pos) override;
+
+
+
+        /**
+         * Sets the length of the spiral
+         * @param l Length
+         */
+        void length(double l) override;
+
+
+
+        /**
+         * Calculates the standard spiral (starting with curvature zero) at the given position. For small arguments,
+         * the power series of the Fresnel integrals is used (if SPIRAL_FAST_FRESNEL is set), otherwise odrSpiral
+         * @param s Position on the standard spiral
+         * @param cDot Derivative of the curvature
+         * @param x x coordinate (will be updated)
+         * @param y y coordinate (will be updated)
+         * @param t Tangent direction (will be updated)
+         */
+        static void standard(double s, double cDot, double &x, double &y, double &t);
+
+
+
         /**
          * Returns the curve position of the spiral at the given position
          * @param s Position
@@ -0,0 +1,665 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-08.
+//
+
+#include "NetworkGenerator.h"
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <curve/Line.h>
+#include <curve/Arc.h>
+#include <curve/Spiral.h>
+#include <curve/Poly3.h>
+
+namespace simmap {
+namespace generator {
+
+
+    /** Directions of the arms of a grid node (counter-clockwise) */
+    enum Direction {
+        EAST = 0, NORTH = 1, WEST = 2, SOUTH = 3
+    };
+
+
+    /** Struct to define a road ending at a grid node */
+    struct Arm {
+        long road = -1;     /**< the index of the road (-1: no road) */
+        bool start = false; /**< flag whether the road starts at the node */
+    };
+
+
+    /**
+     * Creates the curve element of the given geometry
+     * @param g Geometry
+     * @return Curve element
+     */
+    std::unique_ptr<curve::GeoElement> element(const NetworkGenerator::Geometry &g) {
+
+        using namespace simmap::curve;
+
+        std::unique_ptr<GeoElement> ge{};
+
+        if (g.type == "line")
+            ge.reset(new Line(g.length));
+        else if (g.type == "arc")
+            ge.reset(new Arc(g.length, g.p[0]));
+        else if (g.type == "spiral")
+            ge.reset(new Spiral(g.length, g.p[0], g.p[1]));
+        else {
+
+            // parameters (normalized range)
+            double x[4] = {g.p[3], g.p[2], g.p[1], g.p[0]};
+            double y[4] = {g.p[7], g.p[6], g.p[5], g.p[4]};
+
+            ge.reset(new Poly3(g.length, x, y));
+
+        }
+
+        ge->startPoint(g.start);
+
+        return ge;
+
+    }
+
+
+    /**
+     * Calculates the start points of the geometry elements and returns the end point
+     * @param geometry Geometry elements
+     * @param start Start point
+     * @return End point
+     */
+    base::CurvePoint chain(std::vector<NetworkGenerator::Geometry> &geometry, base::CurvePoint start) {
+
+        for (auto &g : geometry) {
+
+            g.start = start;
+            start = element(g)->endPoint();
+
+        }
+
+        return start;
+
+    }
+
+
+    /**
+     * Calculates the arc length of the parametric cubic polynomial (normalized range)
+     * @param p Parameters (aU, bU, cU, dU, aV, bV, cV, dV)
+     * @return Arc length
+     */
+    double polyLength(const double *p) {
+
+        const int n = 64;
+
+        // simpson rule
+        double sum = 0.0;
+        for (int i = 0; i <= n; ++i) {
+
+            double t = static_cast<double>(i) / n;
+            double du = p[1] + 2.0 * p[2] * t + 3.0 * p[3] * t * t;
+            double dv = p[5] + 2.0 * p[6] * t + 3.0 * p[7] * t * t;
+
+            double w = (i == 0 || i == n) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+            sum += w * std::sqrt(du * du + dv * dv);
+
+        }
+
+        return sum / (3.0 * n);
+
+    }
+
+
+    NetworkGenerator::NetworkGenerator(Settings settings) : _settings(settings), _random(settings.seed) {}
+
+
+    void NetworkGenerator::createStraight(Road &road, const base::Vector3 &start, double hdg, double dist) {
+
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        // scale curved elements on short roads
+        double scale = std::min(1.0, dist / 160.0);
+        double kappa = 1.0 / 200.0;
+
+        // create curved part (always returns to the straight line with the same heading)
+        std::vector<Geometry> wiggle{};
+        auto u = uniform(_random);
+
+        if (u < _settings.spiralShare) {
+
+            double l = 10.0 * scale;
+            for (double k : {kappa, -kappa, -kappa, kappa}) {
+                wiggle.push_back({"spiral", l, {0.0, k}});
+                wiggle.push_back({"spiral", l, {k, 0.0}});
+            }
+
+        } else if (u < _settings.spiralShare + _settings.arcShare) {
+
+            double l = 10.0 * scale;
+            wiggle.push_back({"arc", l, {kappa}});
+            wiggle.push_back({"arc", 2.0 * l, {-kappa}});
+            wiggle.push_back({"arc", l, {kappa}});
+
+        } else if (u < _settings.spiralShare + _settings.arcShare + _settings.polyShare) {
+
+            double w = 40.0 * scale, h = 0.5 * scale;
+            for (double sgn : {1.0, -1.0}) {
+
+                Geometry g{"paramPoly3", 0.0, {0.0, w, 0.0, 0.0, 0.0, 0.0, 3.0 * sgn * h, -2.0 * sgn * h}};
+                g.length = polyLength(g.p);
+
+                wiggle.push_back(g);
+
+            }
+
+        }
+
+        // get chord of the curved part and fill up with lines
+        auto pre = 0.5 * (dist - chain(wiggle, base::CurvePoint{}).position.x);
+        if (pre < 0.0) {
+            wiggle.clear();
+            pre = 0.5 * dist;
+        }
+
+        // create geometry
+        road.geometry.clear();
+        if (wiggle.empty())
+            road.geometry.push_back({"line", dist});
+        else {
+            road.geometry.push_back({"line", pre});
+            road.geometry.insert(road.geometry.end(), wiggle.begin(), wiggle.end());
+            road.geometry.push_back({"line", pre});
+        }
+
+        // calculate start points
+        chain(road.geometry, base::CurvePoint{start, hdg, 0.0});
+
+        // calculate length
+        road.length = 0.0;
+        for (const auto &g : road.geometry)
+            road.length += g.length;
+
+    }
+
+
+    void NetworkGenerator::createConnection(Road &road, const base::Vector3 &start, double hdg, int turn) {
+
+        auto r = _settings.junctionRadius;
+
+        // create line or quarter arc
+        if (turn == 0)
+            road.geometry = {{"line", 2.0 * r}};
+        else
+            road.geometry = {{"arc", 0.5 * M_PI * r, {turn / r}}};
+
+        // calculate start point and length
+        chain(road.geometry, base::CurvePoint{start, hdg, 0.0});
+        road.length = road.geometry.front().length;
+
+    }
+
+
+    const Network &NetworkGenerator::generate() {
+
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        // reset
+        _roads.clear();
+        _connectingRoads.clear();
+        _junctions.clear();
+        _network = Network{};
+
+        // find grid size, which provides the requested number of roads
+        size_t n = 1;
+        std::vector<bool> isJunction{};
+        std::vector<std::pair<size_t, size_t>> segments{}; // node indexes (from west to east, from south to north)
+
+        while (segments.size() < _settings.roads) {
+
+            ++n;
+
+            // reset random number generator and select junctions
+            _random.seed(_settings.seed);
+            isJunction.assign(n * n, false);
+            for (size_t i = 0; i < n * n; ++i)
+                isJunction[i] = uniform(_random) < _settings.junctionDensity;
+
+            // create segments: horizontal roads always, vertical roads only between junctions
+            segments.clear();
+            for (size_t j = 0; j < n; ++j) {
+
+                for (size_t i = 0; i + 1 < n; ++i)
+                    segments.emplace_back(j * n + i, j * n + i + 1);
+
+                for (size_t i = 0; j + 1 < n && i < n; ++i) {
+                    if (isJunction[j * n + i] && isJunction[(j + 1) * n + i])
+                        segments.emplace_back(j * n + i, (j + 1) * n + i);
+                }
+
+            }
+
+        }
+
+        // remove overhanging roads
+        segments.resize(_settings.roads);
+
+        // create grid coordinates
+        std::vector<double> xs(n, 0.0), ys(n, 0.0);
+        for (size_t i = 1; i < n; ++i) {
+
+            auto fx = _settings.layout == Layout::CITY ? 0.5 + uniform(_random) : 1.0;
+            auto fy = _settings.layout == Layout::CITY ? 0.5 + uniform(_random) : 1.0;
+
+            xs[i] = xs[i - 1] + fx * _settings.blockLength;
+            ys[i] = ys[i - 1] + fy * _settings.blockLength;
+
+        }
+
+        // set bounds (north, south, east, west)
+        _bounds[0] = ys.back() + _settings.junctionRadius;
+        _bounds[1] = -_settings.junctionRadius;
+        _bounds[2] = xs.back() + _settings.junctionRadius;
+        _bounds[3] = -_settings.junctionRadius;
+
+        // create roads
+        auto r = _settings.junctionRadius;
+        std::vector<std::array<Arm, 4>> arms(n * n);
+        _roads.reserve(segments.size());
+
+        for (const auto &seg : segments) {
+
+            auto i = static_cast<long>(_roads.size());
+            bool horizontal = seg.second == seg.first + 1;
+
+            // get points and direction
+            base::Vector3 p0{xs[seg.first % n], ys[seg.first / n], 0.0};
+            base::Vector3 p1{xs[seg.second % n], ys[seg.second / n], 0.0};
+            double hdg = horizontal ? 0.0 : 0.5 * M_PI;
+
+            // cut out junction areas
+            double r0 = isJunction[seg.first] ? r : 0.0;
+            double r1 = isJunction[seg.second] ? r : 0.0;
+            double dist = horizontal ? p1.x - p0.x : p1.y - p0.y;
+
+            if (horizontal)
+                p0.x += r0;
+            else
+                p0.y += r0;
+
+            // create road
+            _roads.emplace_back();
+            auto &road = _roads.back();
+            road.id = std::to_string(i + 1);
+
+            createStraight(road, p0, hdg, dist - r0 - r1);
+
+            // save arms
+            arms[seg.first][horizontal ? EAST : NORTH] = Arm{i, true};
+            arms[seg.second][horizontal ? WEST : SOUTH] = Arm{i, false};
+
+            // create signals
+            auto ns = static_cast<size_t>(_settings.signalDensity * road.length / 1000.0 + uniform(_random));
+            for (size_t k = 0; k < ns; ++k) {
+
+                auto t = static_cast<int>(uniform(_random) * 5.0);
+                double values[] = {30.0, 50.0, 70.0};
+
+                Signal sig{};
+                sig.s = uniform(_random) * road.length;
+                sig.type = t < 3 ? "274" : (t == 3 ? "205" : "206");
+                sig.value = t < 3 ? values[t] : 0.0;
+                sig.forward = uniform(_random) < 0.5;
+
+                road.signals.push_back(sig);
+
+            }
+
+            _network.signals += ns;
+            _network.length += road.length;
+
+        }
+
+        _network.roads = _roads.size();
+
+        // road IDs of the straight connections along the first row
+        std::vector<std::string> rowConnections(n);
+
+        // create links and junctions
+        for (size_t k = 0; k < n * n; ++k) {
+
+            auto &arm = arms[k];
+
+            // simple link of the horizontal roads
+            if (!isJunction[k]) {
+
+                if (arm[WEST].road != -1 && arm[EAST].road != -1) {
+
+                    auto &rw = _roads[arm[WEST].road];
+                    auto &re = _roads[arm[EAST].road];
+
+                    rw.successor = "elementType=\"road\" elementId=\"" + re.id + "\" contactPoint=\"start\"";
+                    rw.laneSucc = 1;
+
+                    re.predecessor = "elementType=\"road\" elementId=\"" + rw.id + "\" contactPoint=\"end\"";
+                    re.lanePred = 1;
+
+                }
+
+                continue;
+
+            }
+
+            // create connections (no u-turns)
+            std::vector<Connection> connections{};
+            auto jid = std::to_string(_junctions.size() + 1);
+            base::Vector3 c{xs[k % n], ys[k / n], 0.0};
+
+            for (int a = 0; a < 4; ++a) {
+
+                for (int b = 0; b < 4; ++b) {
+
+                    if (a == b || arm[a].road == -1 || arm[b].road == -1)
+                        continue;
+
+                    auto &inc = _roads[arm[a].road];
+                    auto &out = _roads[arm[b].road];
+
+                    // create connecting road
+                    Road con{};
+                    con.id = std::to_string(_roads.size() + _connectingRoads.size() + 1);
+                    con.junction = jid;
+                    con.rightOnly = true;
+
+                    // link roads
+                    con.predecessor = "elementType=\"road\" elementId=\"" + inc.id + "\" contactPoint=\""
+                                      + (arm[a].start ? "start" : "end") + "\"";
+                    con.lanePred = arm[a].start ? -1 : 1;
+
+                    con.successor = "elementType=\"road\" elementId=\"" + out.id + "\" contactPoint=\""
+                                    + (arm[b].start ? "start" : "end") + "\"";
+                    con.laneSucc = arm[b].start ? 1 : -1;
+
+                    // create geometry (right turn if b follows a counter-clockwise)
+                    double phi = 0.5 * M_PI * a;
+                    int turn = (b - a + 4) % 4 == 2 ? 0 : ((b - a + 4) % 4 == 1 ? -1 : 1);
+                    base::Vector3 p{c.x + r * std::cos(phi), c.y + r * std::sin(phi), 0.0};
+
+                    createConnection(con, p, phi + M_PI, turn);
+
+                    // save straight connection on the first row
+                    if (k < n && a == WEST && b == EAST)
+                        rowConnections[k] = con.id;
+
+                    connections.push_back({inc.id, con.id, arm[a].start ? 1 : -1});
+                    _network.length += con.length;
+
+                    _connectingRoads.push_back(con);
+
+                }
+
+            }
+
+            // link roads to junction
+            for (auto &am : arm) {
+
+                if (am.road == -1 || connections.empty())
+                    continue;
+
+                auto &rd = _roads[am.road];
+                (am.start ? rd.predecessor : rd.successor) = "elementType=\"junction\" elementId=\"" + jid + "\"";
+
+            }
+
+            // save junction
+            if (!connections.empty()) {
+                _network.connectingRoads += connections.size();
+                _junctions.push_back(connections);
+            }
+
+        }
+
+        _network.junctions = _junctions.size();
+
+        // create track along the first row
+        for (size_t i = 0; i + 1 < n; ++i) {
+
+            if (i > 0 && isJunction[i]) {
+
+                if (rowConnections[i].empty())
+                    break;
+
+                _network.track.push_back(rowConnections[i]);
+
+            }
+
+            // get road
+            auto rd = arms[i][EAST].road;
+            if (rd == -1)
+                break;
+
+            _network.track.push_back(_roads[rd].id);
+
+        }
+
+        return _network;
+
+    }
+
+
+    void NetworkGenerator::writeLanes(std::ostream &os, const Road &road, bool first, bool last) const {
+
+        auto n = static_cast<int>(_settings.lanes);
+
+        // lane writer
+        auto lane = [&](int id) {
+
+            os << "                    <lane id=\"" << id << "\" type=\"driving\" level=\"false\">\n";
+            os << "                        <link>\n";
+
+            if (!first)
+                os << "                            <predecessor id=\"" << id << "\" />\n";
+            else if (road.lanePred != 0)
+                os << "                            <predecessor id=\"" << road.lanePred * id << "\" />\n";
+
+            if (!last)
+                os << "                            <successor id=\"" << id << "\" />\n";
+            else if (road.laneSucc != 0)
+                os << "                            <successor id=\"" << road.laneSucc * id << "\" />\n";
+
+            os << "                        </link>\n";
+            os << "                        <width sOffset=\"0.0\" a=\"" << _settings.laneWidth
+               << "\" b=\"0.0\" c=\"0.0\" d=\"0.0\" />\n";
+            os << "                        <roadMark sOffset=\"0.0\" type=\"" << (std::abs(id) == n ? "solid" : "broken")
+               << "\" weight=\"standard\" color=\"standard\" width=\"0.12\" laneChange=\"both\" />\n";
+            os << "                    </lane>\n";
+
+        };
+
+        // left lanes
+        if (!road.rightOnly) {
+
+            os << "                <left>\n";
+            for (int i = n; i > 0; --i)
+                lane(i);
+            os << "                </left>\n";
+
+        }
+
+        // center lane
+        os << "                <center>\n";
+        os << "                    <lane id=\"0\" type=\"none\" level=\"false\">\n";
+        os << "                        <roadMark sOffset=\"0.0\" type=\"" << (road.rightOnly ? "none" : "solid")
+           << "\" weight=\"standard\" color=\"standard\" width=\"0.12\" />\n";
+        os << "                    </lane>\n";
+        os << "                </center>\n";
+
+        // right lanes
+        os << "                <right>\n";
+        for (int i = 1; i <= n; ++i)
+            lane(-i);
+        os << "                </right>\n";
+
+    }
+
+
+    void NetworkGenerator::writeRoad(std::ostream &os, const Road &road) const {
+
+        os << "    <road name=\"\" length=\"" << road.length << "\" id=\"" << road.id << "\" junction=\""
+           << road.junction << "\">\n";
+
+        // links
+        os << "        <link>\n";
+        if (!road.predecessor.empty())
+            os << "            <predecessor " << road.predecessor << " />\n";
+        if (!road.successor.empty())
+            os << "            <successor " << road.successor << " />\n";
+        os << "        </link>\n";
+
+        // geometry
+        double s = 0.0;
+        os << "        <planView>\n";
+        for (const auto &g : road.geometry) {
+
+            os << "            <geometry s=\"" << s << "\" x=\"" << g.start.position.x << "\" y=\""
+               << g.start.position.y << "\" hdg=\"" << g.start.angle << "\" length=\"" << g.length << "\">\n";
+
+            if (g.type == "line")
+                os << "                <line />\n";
+            else if (g.type == "arc")
+                os << "                <arc curvature=\"" << g.p[0] << "\" />\n";
+            else if (g.type == "spiral")
+                os << "                <spiral curvStart=\"" << g.p[0] << "\" curvEnd=\"" << g.p[1] << "\" />\n";
+            else
+                os << "                <paramPoly3 aU=\"" << g.p[0] << "\" bU=\"" << g.p[1] << "\" cU=\"" << g.p[2]
+                   << "\" dU=\"" << g.p[3] << "\" aV=\"" << g.p[4] << "\" bV=\"" << g.p[5] << "\" cV=\"" << g.p[6]
+                   << "\" dV=\"" << g.p[7] << "\" pRange=\"normalized\" />\n";
+
+            os << "            </geometry>\n";
+
+            s += g.length;
+
+        }
+        os << "        </planView>\n";
+
+        // lane sections
+        auto m = road.junction == "-1" ? std::max(1u, _settings.laneSections) : 1u;
+
+        os << "        <lanes>\n";
+        for (unsigned int i = 0; i < m; ++i) {
+
+            os << "            <laneSection s=\"" << road.length * i / m << "\">\n";
+            writeLanes(os, road, i == 0, i + 1 == m);
+            os << "            </laneSection>\n";
+
+        }
+        os << "        </lanes>\n";
+
+        // signals
+        os << "        <signals>\n";
+        for (size_t i = 0; i < road.signals.size(); ++i) {
+
+            const auto &sig = road.signals[i];
+            auto t = (_settings.lanes * _settings.laneWidth + 1.0) * (sig.forward ? -1.0 : 1.0);
+
+            os << "            <signal s=\"" << sig.s << "\" t=\"" << t << "\" id=\"" << road.id << "-" << i
+               << "\" name=\"\" dynamic=\"no\" orientation=\"" << (sig.forward ? "+" : "-")
+               << "\" zOffset=\"2.0\" country=\"DEU\" type=\"" << sig.type << "\" subtype=\"-1\" value=\""
+               << sig.value << "\" unit=\"km/h\" height=\"0.6\" width=\"0.6\" />\n";
+
+        }
+        os << "        </signals>\n";
+
+        os << "    </road>\n";
+
+    }
+
+
+    const Network &NetworkGenerator::write(std::ostream &os) {
+
+        // generate if not done yet
+        if (_roads.empty())
+            generate();
+
+        os << std::fixed << std::setprecision(15);
+
+        // header
+        os << "<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\" ?>\n";
+        os << "<OpenDRIVE>\n";
+        os << "    <header revMajor=\"1\" revMinor=\"5\" name=\"SimMap generated network\" version=\"1.00\" date=\"\" "
+           << "north=\"" << _bounds[0] << "\" south=\"" << _bounds[1] << "\" east=\"" << _bounds[2]
+           << "\" west=\"" << _bounds[3] << "\" vendor=\"SimMap\" />\n";
+
+        // roads
+        for (const auto &road : _roads)
+            writeRoad(os, road);
+
+        for (const auto &road : _connectingRoads)
+            writeRoad(os, road);
+
+        // junctions
+        for (size_t i = 0; i < _junctions.size(); ++i) {
+
+            os << "    <junction name=\"\" id=\"" << i + 1 << "\">\n";
+
+            size_t k = 0;
+            for (const auto &con : _junctions[i]) {
+
+                os << "        <connection id=\"" << k++ << "\" incomingRoad=\"" << con.incoming
+                   << "\" connectingRoad=\"" << con.connecting << "\" contactPoint=\"start\">\n";
+
+                for (int l = 1; l <= static_cast<int>(_settings.lanes); ++l)
+                    os << "            <laneLink from=\"" << con.laneSign * l << "\" to=\"" << -l << "\" />\n";
+
+                os << "        </connection>\n";
+
+            }
+
+            os << "    </junction>\n";
+
+        }
+
+        os << "</OpenDRIVE>\n";
+
+        return _network;
+
+    }
+
+
+    const Network &NetworkGenerator::write(const std::string &filename) {
+
+        std::ofstream file(filename);
+        if (!file.is_open())
+            throw std::runtime_error("Could not open file " + filename);
+
+        write(file);
+
+        if (!file.good())
+            throw std::runtime_error("Could not write file " + filename);
+
+        return _network;
+
+    }
+
+}} // namespace ::simmap::generator
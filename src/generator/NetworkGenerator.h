@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-08.
+//
+
+
+#ifndef SIMMAP_GENERATOR_NETWORKGENERATOR_H
+#define SIMMAP_GENERATOR_NETWORKGENERATOR_H
+
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <base/definitions.h>
+
+namespace simmap {
+namespace generator {
+
+
+    /** Layout of the generated network */
+    enum class Layout {
+        GRID, /**< regular grid of equally sized blocks */
+        CITY  /**< grid with randomly sized blocks */
+    };
+
+
+    /** Struct to define the settings of the generator */
+    struct Settings {
+        Layout layout = Layout::GRID;  /**< the layout of the network */
+        unsigned int roads = 100;      /**< the number of roads to be generated (without connecting roads) */
+        unsigned int lanes = 2;        /**< the number of lanes per side */
+        unsigned int laneSections = 1; /**< the number of lane sections per road */
+        double junctionDensity = 1.0;  /**< the share of grid nodes which are junctions (0..1) */
+        double spiralShare = 0.2;      /**< the share of roads with spirals (0..1) */
+        double arcShare = 0.2;         /**< the share of roads with arcs (0..1) */
+        double polyShare = 0.2;        /**< the share of roads with parametric cubic polynomials (0..1) */
+        double signalDensity = 2.0;    /**< the number of signals per road and kilometer */
+        double blockLength = 200.0;    /**< the (mean) distance between two grid nodes */
+        double laneWidth = 3.5;        /**< the width of the lanes */
+        double junctionRadius = 15.0;  /**< the radius of the turns in the junctions */
+        unsigned int seed = 1;         /**< the seed of the random number generator */
+    };
+
+
+    /** Struct to store information about a generated network */
+    struct Network {
+        unsigned long roads = 0;            /**< the number of roads (without connecting roads) */
+        unsigned long connectingRoads = 0;  /**< the number of connecting roads */
+        unsigned long junctions = 0;        /**< the number of junctions */
+        unsigned long signals = 0;          /**< the number of signals */
+        double length = 0.0;                /**< the accumulated length of all roads */
+        std::vector<std::string> track{};   /**< a track along the first row of the grid (incl. connecting roads) */
+    };
+
+
+    /**
+     * @brief Generator for synthetic OpenDRIVE road networks
+     * The network is a grid of roads (with or without curved elements in between), the grid nodes are either junctions
+     * with connecting roads for each direction or simple road links. The generator is deterministic for a given seed.
+     */
+    class NetworkGenerator {
+
+    public:
+
+        /** Struct to define a geometry element of a road */
+        struct Geometry {
+            std::string type{};               /**< the OpenDRIVE type (line, arc, spiral, paramPoly3) */
+            double length = 0.0;              /**< the length of the element */
+            double p[8] = {0.0};              /**< the parameters (curvatures or polynomial coefficients) */
+            base::CurvePoint start{};         /**< the start point of the element */
+        };
+
+
+        /** Struct to define a signal */
+        struct Signal {
+            double s = 0.0;                   /**< the position of the signal on the road */
+            std::string type{};               /**< the signal type (StVO) */
+            double value = 0.0;               /**< the value of the signal (e.g. speed limit) */
+            bool forward = true;              /**< flag whether the signal is valid in road direction */
+        };
+
+
+        /** Struct to define a road */
+        struct Road {
+            std::string id{};                 /**< the road ID */
+            std::string junction = "-1";      /**< the junction ID (-1 if not a connecting road) */
+            std::string predecessor{};        /**< the XML attributes of the predecessor link (empty if none) */
+            std::string successor{};          /**< the XML attributes of the successor link (empty if none) */
+            int lanePred = 0;                 /**< the factor of the predecessor lane IDs (0: no link) */
+            int laneSucc = 0;                 /**< the factor of the successor lane IDs (0: no link) */
+            bool rightOnly = false;           /**< flag whether the road only has right lanes */
+            double length = 0.0;              /**< the length of the road */
+            std::vector<Geometry> geometry{}; /**< the geometry elements */
+            std::vector<Signal> signals{};    /**< the signals */
+        };
+
+
+        /** Struct to define a connection of a junction */
+        struct Connection {
+            std::string incoming{};           /**< the incoming road */
+            std::string connecting{};         /**< the connecting road */
+            int laneSign = -1;                /**< the sign of the IDs of the incoming lanes */
+        };
+
+
+    protected:
+
+        Settings _settings;
+        std::mt19937 _random;
+
+        std::vector<Road> _roads{};
+        std::vector<Road> _connectingRoads{};
+        std::vector<std::vector<Connection>> _junctions{};
+        Network _network{};
+
+        double _bounds[4] = {0.0, 0.0, 0.0, 0.0};
+
+
+        /**
+         * Creates the geometry of a road between the two points with the given direction
+         * @param road Road to be filled
+         * @param start Start point
+         * @param hdg Heading
+         * @param dist Distance between start and end point
+         */
+        void createStraight(Road &road, const base::Vector3 &start, double hdg, double dist);
+
+
+        /**
+         * Creates the geometry of a connecting road (line or quarter arc)
+         * @param road Road to be filled
+         * @param start Start point
+         * @param hdg Heading
+         * @param turn Turn direction (0: straight, 1: left, -1: right)
+         */
+        void createConnection(Road &road, const base::Vector3 &start, double hdg, int turn);
+
+
+        /**
+         * Writes the road
+         * @param os Output stream
+         * @param road Road
+         */
+        void writeRoad(std::ostream &os, const Road &road) const;
+
+
+        /**
+         * Writes the lanes of a lane section
+         * @param os Output stream
+         * @param road Road
+         * @param first Flag whether the section is the first of the road
+         * @param last Flag whether the section is the last of the road
+         */
+        void writeLanes(std::ostream &os, const Road &road, bool first, bool last) const;
+
+
+    public:
+
+        /**
+         * Constructor
+         * @param settings Settings
+         */
+        explicit NetworkGenerator(Settings settings);
+
+
+        /**
+         * Generates the network
+         * @return Information about the network
+         */
+        const Network &generate();
+
+
+        /**
+         * Writes the network as OpenDRIVE (the network is generated if not done yet)
+         * @param os Output stream
+         * @return Information about the network
+         */
+        const Network &write(std::ostream &os);
+
+
+        /**
+         * Writes the network to the given file (the network is generated if not done yet)
+         * @param filename File name
+         * @return Information about the network
+         */
+        const Network &write(const std::string &filename);
+
+    };
+
+}} // namespace ::simmap::generator
+
+#endif // SIMMAP_GENERATOR_NETWORKGENERATOR_H
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <cxxopts.hpp>
+#include "NetworkGenerator.h"
+
+int main(int argc, char **argv) {
+
+    using namespace simmap::generator;
+
+    // set options
+    cxxopts::Options options("SimMap map generator", "This tool generates synthetic road networks (OpenDRIVE).");
+    options.add_options()
+            ("o,output", "Output file, required", cxxopts::value<std::string>())
+            ("l,layout", "Layout of the network: grid or city (default: grid)",
+             cxxopts::value<std::string>()->default_value("grid"))
+            ("r,roads", "Number of roads without connecting roads (default: 100)",
+             cxxopts::value<unsigned int>()->default_value("100"))
+            ("n,lanes", "Number of lanes per side (default: 2)",
+             cxxopts::value<unsigned int>()->default_value("2"))
+            ("s,sections", "Number of lane sections per road (default: 1)",
+             cxxopts::value<unsigned int>()->default_value("1"))
+            ("j,junctions", "Share of grid nodes which are junctions (default: 1.0)",
+             cxxopts::value<double>()->default_value("1.0"))
+            ("spirals", "Share of roads with spirals (default: 0.2)",
+             cxxopts::value<double>()->default_value("0.2"))
+            ("arcs", "Share of roads with arcs (default: 0.2)",
+             cxxopts::value<double>()->default_value("0.2"))
+            ("polys", "Share of roads with parametric cubic polynomials (default: 0.2)",
+             cxxopts::value<double>()->default_value("0.2"))
+            ("signals", "Number of signals per road and kilometer (default: 2.0)",
+             cxxopts::value<double>()->default_value("2.0"))
+            ("b,block", "Mean distance between the grid nodes (default: 200.0)",
+             cxxopts::value<double>()->default_value("200.0"))
+            ("seed", "Seed of the random number generator (default: 1)",
+             cxxopts::value<unsigned int>()->default_value("1"))
+            ("h,help", "Show help");
+
+    // parse result
+    auto result = options.parse(argc, argv);
+
+    // print help and end
+    if (result.count("help")) {
+        std::cout << options.help() << std::endl;
+        exit(0);
+    }
+
+    // check required options
+    if (!result.count("output")) {
+        std::cerr << "Error: Please provide an output file." << std::endl;
+        return 1;
+    }
+
+    // check layout
+    auto layout = result["layout"].as<std::string>();
+    if (layout != "grid" && layout != "city") {
+        std::cerr << "Error: Unknown layout " << layout << "." << std::endl;
+        return 1;
+    }
+
+    // settings
+    Settings settings;
+    settings.layout = layout == "city" ? Layout::CITY : Layout::GRID;
+    settings.roads = result["roads"].as<unsigned int>();
+    settings.lanes = std::max(1u, result["lanes"].as<unsigned int>());
+    settings.laneSections = std::max(1u, result["sections"].as<unsigned int>());
+    settings.junctionDensity = result["junctions"].as<double>();
+    settings.spiralShare = result["spirals"].as<double>();
+    settings.arcShare = result["arcs"].as<double>();
+    settings.polyShare = result["polys"].as<double>();
+    settings.signalDensity = result["signals"].as<double>();
+    settings.blockLength = result["block"].as<double>();
+    settings.seed = result["seed"].as<unsigned int>();
+
+    // generate and write
+    NetworkGenerator generator(settings);
+    auto &network = generator.write(result["output"].as<std::string>());
+
+    // print summary
+    std::cout << "Roads:            " << network.roads << std::endl;
+    std::cout << "Connecting roads: " << network.connectingRoads << std::endl;
+    std::cout << "Junctions:        " << network.junctions << std::endl;
+    std::cout << "Signals:          " << network.signals << std::endl;
+    std::cout << "Length:           " << network.length / 1000.0 << " km" << std::endl;
+
+    return 0;
+
+}
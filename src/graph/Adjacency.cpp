@@ -0,0 +1,363 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-19.
+//
+
+#include "Adjacency.h"
+#include "Edge.h"
+#include <algorithm>
+
+
+namespace graph {
+
+
+    void Adjacency::build(const std::vector<Edge *> &edges) {
+
+        auto n = edges.size();
+
+        _nextOffsets.assign(1, 0);
+        _prevOffsets.assign(1, 0);
+        _leftOffsets.assign(1, 0);
+        _rightOffsets.assign(1, 0);
+
+        _nexts.clear();
+        _prevs.clear();
+        _lefts.clear();
+        _rights.clear();
+
+        // adds the links of the connections
+        auto links = [](const Oriented::Connections &con, std::vector<Link> &list) {
+
+            for (const auto &c : con)
+                list.push_back(Link{dynamic_cast<const Edge *>(c.second), c.first});
+
+        };
+
+        // adds the neighbors of the sequence
+        auto laterals = [](const Edge *edge, const auto &seq, std::vector<Lateral> &list) {
+
+            for (const auto &e : seq) {
+
+                auto neighbor = dynamic_cast<const Edge *>(e.element);
+                list.push_back(Lateral{e.position, e.position + e.length, neighbor,
+                                       neighbor->isForward() == edge->isForward()});
+
+            }
+
+        };
+
+        for (size_t i = 0; i < n; ++i) {
+
+            auto edge = edges[i];
+
+            links(edge->nexts(), _nexts);
+            links(edge->prevs(), _prevs);
+            laterals(edge, edge->left(), _lefts);
+            laterals(edge, edge->right(), _rights);
+
+            _nextOffsets.push_back(_nexts.size());
+            _prevOffsets.push_back(_prevs.size());
+            _leftOffsets.push_back(_lefts.size());
+            _rightOffsets.push_back(_rights.size());
+
+        }
+
+        // resolve the neighbors into strips
+        _buildStrips(edges);
+
+    }
+
+
+    Adjacency::Range<Adjacency::Link> Adjacency::nexts(size_t handle) const {
+
+        return {_nexts.data() + _nextOffsets[handle], _nexts.data() + _nextOffsets[handle + 1]};
+
+    }
+
+
+    Adjacency::Range<Adjacency::Link> Adjacency::prevs(size_t handle) const {
+
+        return {_prevs.data() + _prevOffsets[handle], _prevs.data() + _prevOffsets[handle + 1]};
+
+    }
+
+
+    Adjacency::Range<Adjacency::Lateral> Adjacency::neighbors(size_t handle, Neighbored::Side side) const {
+
+        if (side == Neighbored::Side::LEFT)
+            return {_lefts.data() + _leftOffsets[handle], _lefts.data() + _leftOffsets[handle + 1]};
+
+        return {_rights.data() + _rightOffsets[handle], _rights.data() + _rightOffsets[handle + 1]};
+
+    }
+
+
+    std::pair<double, const Edge *> Adjacency::neighbor(size_t handle, double s, Neighbored::Side side) const {
+
+        auto range = neighbors(handle, side);
+
+        // check range
+        if (range.empty() || s < range.first->start - base::EPS_DISTANCE
+            || s > (range.last - 1)->end + base::EPS_DISTANCE)
+            return {0.0, nullptr};
+
+        // find neighbor (last one which starts before the position)
+        auto it = std::upper_bound(range.begin(), range.end(), s,
+                                   [](double v, const Lateral &l) { return v < l.start; });
+
+        if (it != range.begin())
+            --it;
+
+        // get position in the neighbor
+        auto sn = s - it->start;
+        if (!it->sameDirection)
+            sn = it->edge->length() - sn;
+
+        return {sn, it->edge};
+
+    }
+
+
+    std::pair<double, const Edge *> Adjacency::neighbor(size_t handle, double s, Neighbored::Side side,
+                                                        size_t number) const {
+
+        size_t index;
+        double position;
+
+        auto range = strip(handle, s, index, position);
+        if (range.empty())
+            return {0.0, nullptr};
+
+        const auto &edge = range.first[index];
+        if (number == 0)
+            return {s, edge.edge};
+
+        // the left side of the edge is the left side of the strip, if the edge has the direction of the strip
+        auto toLeft = (side == Neighbored::Side::LEFT) == edge.sameDirection;
+        if (toLeft ? number > index : index + number >= range.size())
+            return {0.0, nullptr};
+
+        // get neighbor and position in the neighbor
+        const auto &n = range.first[toLeft ? index - number : index + number];
+        auto sn = std::min(n.edge->length(), std::max(0.0, n.position(position)));
+
+        return {sn, n.edge};
+
+    }
+
+
+    Adjacency::Range<Adjacency::StripEdge> Adjacency::strip(size_t handle, double s, size_t &index,
+                                                            double &position) const {
+
+        auto first = _intervals.data() + _intervalOffsets[handle];
+        auto last = _intervals.data() + _intervalOffsets[handle + 1];
+
+        if (first == last)
+            return {nullptr, nullptr};
+
+        // find interval (last one which starts before the position)
+        auto it = std::upper_bound(first, last, s, [](double v, const StripInterval &i) { return v < i.start; });
+
+        if (it != first)
+            --it;
+
+        // get strip and position in the strip
+        auto strip = it->strip;
+        Range<StripEdge> range{_strips.data() + _stripOffsets[strip], _strips.data() + _stripOffsets[strip + 1]};
+
+        index = it->index;
+        position = range.first[index].sameDirection ? s - range.first[index].offset : range.first[index].offset - s;
+
+        return range;
+
+    }
+
+
+    size_t Adjacency::strips() const {
+
+        return _stripOffsets.size() - 1;
+
+    }
+
+
+    void Adjacency::_buildStrips(const std::vector<Edge *> &edges) {
+
+        _stripOffsets.assign(1, 0);
+        _intervalOffsets.assign(1, 0);
+
+        _strips.clear();
+        _intervals.clear();
+
+        // intervals of the strips for each edge
+        std::vector<std::vector<StripInterval>> intervals(edges.size());
+
+        // collects the edges on the given side of the reference edge along the interval [a, b] of the reference edge.
+        // Returns false and the position of the change, if the neighbors change within the interval.
+        auto walk = [this, &edges](const Edge *ref, double a, double b, Neighbored::Side side,
+                                   std::vector<StripEdge> &chain, double &change) {
+
+            StripEdge current{ref, 0.0, true};
+
+            while (true) {
+
+                auto range = neighbors(current.edge->handle(), side);
+                if (range.empty())
+                    return true;
+
+                // get interval in the current edge
+                auto xa = std::min(current.position(a), current.position(b));
+                auto xb = std::max(current.position(a), current.position(b));
+
+                // checks whether the neighbors change at the given position and calculates the reference position
+                auto changes = [&](double p) {
+
+                    if (p <= xa + base::EPS_DISTANCE || p >= xb - base::EPS_DISTANCE)
+                        return false;
+
+                    change = current.sameDirection ? p - current.offset : current.offset - p;
+                    return true;
+
+                };
+
+                for (const auto &l : range) {
+                    if (changes(l.start))
+                        return false;
+                }
+
+                if (changes((range.last - 1)->end))
+                    return false;
+
+                // check range
+                auto xm = 0.5 * (xa + xb);
+                if (xm < range.first->start - base::EPS_DISTANCE || xm > (range.last - 1)->end + base::EPS_DISTANCE)
+                    return true;
+
+                // find neighbor (last one which starts before the position)
+                auto it = std::upper_bound(range.begin(), range.end(), xm,
+                                           [](double v, const Lateral &l) { return v < l.start; });
+
+                if (it != range.begin())
+                    --it;
+
+                // stop at loops and at edges not being part of the graph
+                auto h = it->edge->handle();
+                if (it->edge == ref || h >= edges.size() || edges[h] != it->edge ||
+                    std::any_of(chain.begin(), chain.end(), [&it](const StripEdge &e) { return e.edge == it->edge; }))
+                    return true;
+
+                // calculate the position mapping of the neighbor
+                if (it->sameDirection)
+                    current = StripEdge{it->edge, current.offset - it->start, current.sameDirection};
+                else
+                    current = StripEdge{it->edge, it->edge->length() - current.offset + it->start,
+                                        !current.sameDirection};
+
+                // switch side if the neighbor has the opposite direction
+                if (!it->sameDirection)
+                    side = Neighbored::switchSide(side);
+
+                chain.push_back(current);
+
+            }
+
+        };
+
+        for (size_t i = 0; i < edges.size(); ++i) {
+
+            auto edge = edges[i];
+            auto &covered = intervals[i];
+
+            // get intervals not yet covered by a strip of a neighbor
+            std::sort(covered.begin(), covered.end(),
+                      [](const StripInterval &i0, const StripInterval &i1) { return i0.start < i1.start; });
+
+            std::vector<std::pair<double, double>> open{};
+            double cursor = 0.0;
+            for (const auto &c : covered) {
+
+                if (c.start > cursor + base::EPS_DISTANCE)
+                    open.emplace_back(cursor, c.start);
+
+                cursor = std::max(cursor, c.end);
+
+            }
+
+            if (covered.empty() || cursor < edge->length() - base::EPS_DISTANCE)
+                open.emplace_back(cursor, edge->length());
+
+            // create strips (intervals are split at the changes of the neighbors)
+            while (!open.empty()) {
+
+                auto a = open.back().first;
+                auto b = open.back().second;
+                open.pop_back();
+
+                std::vector<StripEdge> left{}, right{};
+                double change = 0.0;
+
+                if (!walk(edge, a, b, Neighbored::Side::LEFT, left, change)
+                    || !walk(edge, a, b, Neighbored::Side::RIGHT, right, change)) {
+
+                    open.emplace_back(change, b);
+                    open.emplace_back(a, change);
+                    continue;
+
+                }
+
+                // add strip from the leftmost to the rightmost edge
+                auto strip = _stripOffsets.size() - 1;
+
+                _strips.insert(_strips.end(), left.rbegin(), left.rend());
+                _strips.push_back(StripEdge{edge, 0.0, true});
+                _strips.insert(_strips.end(), right.begin(), right.end());
+
+                // add interval to the edges of the strip
+                for (auto k = _stripOffsets.back(); k < _strips.size(); ++k) {
+
+                    const auto &e = _strips[k];
+                    auto s0 = e.position(a), s1 = e.position(b);
+
+                    intervals[e.edge->handle()].push_back(StripInterval{std::min(s0, s1), std::max(s0, s1), strip,
+                                                                        k - _stripOffsets.back()});
+
+                }
+
+                _stripOffsets.push_back(_strips.size());
+
+            }
+
+        }
+
+        // store sorted intervals
+        for (auto &list : intervals) {
+
+            std::sort(list.begin(), list.end(),
+                      [](const StripInterval &i0, const StripInterval &i1) { return i0.start < i1.start; });
+
+            _intervals.insert(_intervals.end(), list.begin(), list.end());
+            _intervalOffsets.push_back(_intervals.size());
+
+        }
+
+    }
+
+}
@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-19.
+//
+
+#ifndef SIMMAP_GRAPH_ADJACENCY_H
+#define SIMMAP_GRAPH_ADJACENCY_H
+
+#include <vector>
+#include <utility>
+#include <base/definitions.h>
+#include "Neighbored.h"
+
+namespace graph {
+
+    // pre-define edge class
+    class Edge;
+
+
+    /**
+     * class Adjacency
+     * Frozen adjacency of the edges of a graph in compressed sparse row format. The successors, the predecessors and
+     * the lateral neighbors of all edges are stored in contiguous arrays, the range of an edge is given by its handle.
+     * The adjacency is created by Graph::index and must be re-created if the links of the edges are changed.
+     *
+     * Additionally, the lateral neighbors are resolved into strips: A strip is the ordered list of all laterally
+     * connected edges (from the leftmost to the rightmost edge) along an interval in which the neighbors do not change
+     * (e.g. a lane section). Each edge stores the intervals of its strips, so that the n-th neighbor is found by one
+     * lookup of the position and an index in the strip.
+     */
+    class Adjacency {
+
+    public:
+
+        /** Struct to define a link to a successor or a predecessor */
+        struct Link {
+            const Edge *edge;               //!< The linked edge
+            base::ContactPoint contact;     //!< The contact point of the linked edge
+        };
+
+
+        /** Struct to define a lateral neighbor */
+        struct Lateral {
+            double start;                   //!< The start position of the neighbor in the edge
+            double end;                     //!< The end position of the neighbor in the edge
+            const Edge *edge;               //!< The neighbored edge
+            bool sameDirection;             //!< Flag whether the neighbor has the same orientation as the edge
+        };
+
+
+        /** Struct to define an edge of a strip */
+        struct StripEdge {
+            const Edge *edge;               //!< The edge
+            double offset;                  //!< The position in the edge at the reference position zero of the strip
+            bool sameDirection;             //!< Flag whether the edge has the same orientation as the strip
+
+            /** Returns the position in the edge for the given position of the strip */
+            double position(double s) const { return sameDirection ? offset + s : offset - s; }
+        };
+
+
+        /** Struct to define the interval of an edge covered by a strip */
+        struct StripInterval {
+            double start;                   //!< The start position of the interval in the edge
+            double end;                     //!< The end position of the interval in the edge
+            size_t strip;                   //!< The index of the strip
+            size_t index;                   //!< The index of the edge in the strip
+        };
+
+
+        /** A range of contiguous elements */
+        template<typename T>
+        struct Range {
+
+            const T *first;
+            const T *last;
+
+            const T *begin() const { return first; }
+            const T *end() const { return last; }
+            size_t size() const { return static_cast<size_t>(last - first); }
+            bool empty() const { return first == last; }
+
+        };
+
+
+    private:
+
+        std::vector<size_t> _nextOffsets{};
+        std::vector<size_t> _prevOffsets{};
+        std::vector<size_t> _leftOffsets{};
+        std::vector<size_t> _rightOffsets{};
+
+        std::vector<Link> _nexts{};
+        std::vector<Link> _prevs{};
+        std::vector<Lateral> _lefts{};
+        std::vector<Lateral> _rights{};
+
+        std::vector<size_t> _stripOffsets{};
+        std::vector<size_t> _intervalOffsets{};
+
+        std::vector<StripEdge> _strips{};
+        std::vector<StripInterval> _intervals{};
+
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        Adjacency() = default;
+
+
+        /**
+         * Creates the adjacency of the given edges (the index in the vector is the handle of the edge)
+         * @param edges Edges
+         */
+        void build(const std::vector<Edge *> &edges);
+
+
+        /**
+         * Returns the successors of the edge with the given handle
+         * @param handle Handle of the edge
+         * @return Successors
+         */
+        Range<Link> nexts(size_t handle) const;
+
+
+        /**
+         * Returns the predecessors of the edge with the given handle
+         * @param handle Handle of the edge
+         * @return Predecessors
+         */
+        Range<Link> prevs(size_t handle) const;
+
+
+        /**
+         * Returns the lateral neighbors on the given side (in reference direction) of the edge with the given handle
+         * @param handle Handle of the edge
+         * @param side Side
+         * @return Neighbors, sorted by the start position
+         */
+        Range<Lateral> neighbors(size_t handle, Neighbored::Side side) const;
+
+
+        /**
+         * Returns the direct neighbor at the given position (see Neighbored::neighbor)
+         * @param handle Handle of the edge
+         * @param s Position in the edge
+         * @param side Side
+         * @return Position in the neighbor and the neighbor (nullptr if there is no neighbor)
+         */
+        std::pair<double, const Edge *> neighbor(size_t handle, double s, Neighbored::Side side) const;
+
+
+        /**
+         * Returns the n-th neighbor at the given position (see Neighbored::neighbor) from the strip of the position
+         * @param handle Handle of the edge
+         * @param s Position in the edge
+         * @param side Side
+         * @param number Number of neighbors to the given side
+         * @return Position in the neighbor and the neighbor (nullptr if there is no neighbor)
+         */
+        std::pair<double, const Edge *> neighbor(size_t handle, double s, Neighbored::Side side, size_t number) const;
+
+
+        /**
+         * Returns the strip of the edge with the given handle at the given position
+         * @param handle Handle of the edge
+         * @param s Position in the edge
+         * @param index Index of the edge in the strip
+         * @param position Position in the strip
+         * @return Edges of the strip (from the leftmost to the rightmost edge in the direction of the strip)
+         */
+        Range<StripEdge> strip(size_t handle, double s, size_t &index, double &position) const;
+
+
+        /**
+         * Returns the number of strips
+         * @return Number of strips
+         */
+        size_t strips() const;
+
+
+    protected:
+
+        /**
+         * Creates the strips of the given edges (the lateral neighbors must be created before)
+         * @param edges Edges
+         */
+        void _buildStrips(const std::vector<Edge *> &edges);
+
+    };
+
+}
+
+
+#endif // SIMMAP_GRAPH_ADJACENCY_H
@@ -34,6 +34,20 @@ namespace graph {
     }
 
 
+    size_t Edge::handle() const {
+
+        return _handle;
+
+    }
+
+
+    const Adjacency *Edge::adjacency() const {
+
+        return _adjacency;
+
+    }
+
+
     bool Edge::isForward() const {
 
         return !(orientation() == base::Orientation::BACKWARDS);
@@ -28,12 +28,14 @@
 #include <vector>
 #include <tuple>
 #include <string>
+#include <limits>
 #include "Oriented.h"
 #include "Neighbored.h"
 
 namespace graph {
 
     class Object;
+    class Adjacency;
 
     /**
      * class Edge
@@ -49,6 +51,10 @@ namespace graph {
 
         std::string _id; //!< The ID of the edge
 
+        size_t _handle = std::numeric_limits<size_t>::max(); //!< The handle of the edge (see Graph::index)
+
+        const Adjacency *_adjacency = nullptr; //!< The adjacency of the graph the edge is indexed in
+
 
         /**
          * Default constructor
@@ -69,6 +75,20 @@ namespace graph {
         const std::string &id() const;
 
 
+        /**
+         * Returns the handle of the edge (dense index in the graph, set by Graph::index)
+         * @return Handle of the edge
+         */
+        size_t handle() const;
+
+
+        /**
+         * Returns the frozen adjacency of the graph, the edge is indexed in (see Graph::index)
+         * @return Adjacency (nullptr if the edge is not indexed)
+         */
+        const Adjacency *adjacency() const;
+
+
         /**
          * Returns the stored direction of the edge
          * @return Storage direction
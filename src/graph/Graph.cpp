@@ -25,10 +25,14 @@
 #include "Graph.h"
 #include "Edge.h"
 #include <iostream>
+#include <limits>
 
 namespace graph {
 
 
+    const size_t Graph::NONE = std::numeric_limits<size_t>::max();
+
+
     void Graph::autoConnect(const std::vector<std::pair<double, std::vector<Edge *>>> &edges) {
 
         // iterate over sequences
@@ -85,4 +89,44 @@ namespace graph {
     }
 
 
+    void Graph::index() {
+
+        _edges.clear();
+        _handles.clear();
+
+        _edges.reserve(size());
+        _handles.reserve(size());
+
+        // assign handles in the order of the IDs
+        for (auto &e : *this) {
+
+            e.second->_handle = _edges.size();
+            e.second->_adjacency = &_adjacency;
+
+            _handles[e.first] = _edges.size();
+            _edges.push_back(e.second.get());
+
+        }
+
+        // freeze links and neighbors
+        _adjacency.build(_edges);
+
+    }
+
+
+    size_t Graph::handle(const std::string &id) const {
+
+        auto it = _handles.find(id);
+        return it == _handles.end() ? NONE : it->second;
+
+    }
+
+
+    Edge *Graph::edge(size_t handle) const {
+
+        return handle < _edges.size() ? _edges[handle] : nullptr;
+
+    }
+
+
 }
\ No newline at end of file
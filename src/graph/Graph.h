@@ -30,7 +30,10 @@
 #include <tuple>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <base/definitions.h>
+#include "Adjacency.h"
 
 
 namespace graph {
@@ -53,6 +56,15 @@ namespace graph {
         typedef std::list<OrientedEdge> EdgeList;
 
 
+        /** The handle of a missing edge */
+        static const size_t NONE;
+
+
+        std::vector<Edge *> _edges{};                          //!< The edges by handle
+        std::unordered_map<std::string, size_t> _handles{};   //!< The handles by ID
+        Adjacency _adjacency{};                                //!< The frozen adjacency by handle
+
+
         /**
          * Default constructor
          */
@@ -79,6 +91,29 @@ namespace graph {
         static void autoConnect(const std::vector<std::pair<double, std::vector<Edge *>>> &edges);
 
 
+        /**
+         * Assigns a dense handle to each edge, interns the IDs in a hash table and freezes the adjacency of the edges.
+         * Must be called again after edges are added, removed or linked and after the graph is moved
+         */
+        void index();
+
+
+        /**
+         * Returns the handle of the edge with the given ID
+         * @param id ID of the edge
+         * @return Handle (NONE if the edge does not exist or the graph is not indexed)
+         */
+        size_t handle(const std::string &id) const;
+
+
+        /**
+         * Returns the edge with the given handle
+         * @param handle Handle of the edge
+         * @return Edge (nullptr if the handle is not valid)
+         */
+        Edge *edge(size_t handle) const;
+
+
     };
 
 }
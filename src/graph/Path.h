@@ -28,6 +28,9 @@
 #include <vector>
 #include <list>
 #include <cmath>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
 #include "Edge.h"
 
 namespace graph {
@@ -35,19 +38,22 @@ namespace graph {
     class Object;
 
     /**
-     * class Path
+     * class TypedPath
+     * The path stores the edges with the given edge type, so that derived paths can access the edges without casts.
+     * @tparam E Edge type (derived from Edge)
      * @author Jens Klimke jens.klimke@rwth-aachen.de
      */
-    class Path {
+    template<typename E>
+    class TypedPath {
 
 
     protected:
 
         /** Type definition for a list of edges. */
-        typedef std::list<const Edge *> edge_vector_t;
+        typedef std::list<const E *> edge_vector_t;
 
         /** Type definition for an iterator of edge lists. */
-        typedef edge_vector_t::const_iterator iterator_t;
+        typedef typename edge_vector_t::const_iterator iterator_t;
 
         /**
          * Structure to store an edge list iterator and a position.
@@ -81,20 +87,27 @@ namespace graph {
         /**
          * Default constructor
          */
-        Path() = default;
+        TypedPath() = default;
 
 
         /**
          * Copy constructor
          * @param p Path to be copied
          */
-        Path(const Path &p);
+        TypedPath(const TypedPath &p);
 
 
         /**
          * Default destructor
          */
-        virtual ~Path() = default;
+        virtual ~TypedPath() = default;
+
+
+        /**
+         * Checks whether the path is empty (not created yet)
+         * @return Flag whether the path is empty
+         */
+        bool empty() const;
 
 
         /**
@@ -208,10 +221,342 @@ namespace graph {
 
     };
 
+
+    /** Path on generic edges */
+    typedef TypedPath<Edge> Path;
+
+
+    template<typename E>
+    TypedPath<E>::TypedPath(const TypedPath &p) {
+
+        // copy attributes
+        this->_s = p._s;
+        this->_headPos = p._headPos;
+        this->_backPos = p._backPos;
+
+        // copy segments and set iterator to first element
+        this->_segments = p._segments;
+        this->_it = this->_segments.begin();
+
+        // abort if path has no elements
+        if (_segments.empty())
+            return;
+
+        // set iterator
+        for (auto it = p._segments.begin(); it != p._it; ++it, ++_it);
+
+    }
+
+
+    template<typename E>
+    bool TypedPath<E>::empty() const {
+
+        return _segments.empty();
+
+    }
+
+
+    template<typename E>
+    double TypedPath<E>::distanceToHead() const {
+
+        return _body().back().s;
+
+    }
+
+
+    template<typename E>
+    double TypedPath<E>::distanceToBack() const {
+
+        return _tail().back().s;
+
+    }
+
+
+    template<typename E>
+    void TypedPath<E>::position(double s) {
+
+        if (s > distanceToHead() || s < -distanceToBack())
+            throw std::invalid_argument("wrong s");
+
+        // get iterator
+        auto r = index(s);
+
+        // set data
+        _it = r.it;
+        _s = r.s;
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::ObjectsList TypedPath<E>::objects() const {
+
+        ObjectsList list{};
+
+        // create iterator and distance counter
+        double ss = 0.0;
+        double sPos = 0.0;
+
+        for (auto it = _segments.begin(); it != _segments.end(); ++it) {
+
+            // get edge
+            auto edge = *it;
+
+            // get interval in edge
+            double s0 = it == _segments.begin() ? _backPos : 0.0;
+            double s1 = it == _head().it ? _headPos : edge->length();
+
+            // if edge is the position edge, save the distance from the start to the position
+            if (it == _it)
+                sPos = ss + _s - s0;
+
+            // get objects
+            auto objs = edge->objects();
+            for (auto obj : objs) {
+
+                // get s relative to edge and check if s is in interval
+                auto s = obj.first;
+                if (s < s0 || s > s1)
+                    continue;
+
+                // get distance from position and add to list
+                list.push_back(std::pair<double, const Object *>{ss + s - s0, obj.second});
+
+            }
+
+            // update
+            ss += s1 - s0;
+
+        }
+
+        // update position
+        for (auto &el : list)
+            el.first -= sPos;
+
+        return list;
+
+    }
+
+
+    template<typename E>
+    void TypedPath<E>::_set(size_t i, double s, double back, double head) {
+
+        _it = std::next(_segments.begin(), i);
+        _s = s;
+        _backPos = back;
+        _headPos = head;
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::position_t TypedPath<E>::index(double s) const {
+
+        if (s == 0.0)
+            return _position();
+        else if (s < 0.0)
+            return {index_bw(s), s};
+        else
+            return {index_fw(s), s};
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::iterator_t TypedPath<E>::index_fw(double &s) const {
+
+        // check if s is positive
+        if (s < 0.0)
+            throw std::invalid_argument("s must be positive");
+
+        // get body part until s is reached
+        auto r = _body(s);
+        auto sm = r.back().s;
+
+        // check result (resultant position must be equal to search position)
+        if (std::abs(sm - s) >= base::EPS_DOUBLE_CMP)
+            throw std::invalid_argument("Wrong s");
+
+        // update s
+        if (r.size() > 1)
+            s = sm - std::next(r.begin(), r.size() - 2)->s;
+        else
+            s = sm + _s;
+
+        // return iterator
+        return r.back().it;
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::iterator_t TypedPath<E>::index_bw(double &s) const {
+
+        // check if s is positive
+        if (s > 0.0)
+            throw std::invalid_argument("s must be negative");
+
+        // get tail part until s is reached
+        auto r = _tail(-s);
+
+        // check result (resultant position must be equal to search position)
+        auto sm = r.back().s;
+        if (std::abs(sm + s) > base::EPS_DOUBLE_CMP)
+            throw std::invalid_argument("Wrong s");
+
+        // update s
+        if (r.size() > 1) {
+            auto it = std::next(r.begin(), r.size() - 2);
+            s = (*std::next(it, 1)->it)->length() + it->s - sm;
+        } else {
+            s = _s - sm;
+        }
+
+        // return iterator
+        return r.back().it;
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::position_t TypedPath<E>::_position() const {
+
+        return {_it, _s};
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::position_t TypedPath<E>::_head() const {
+
+        return {std::next(_segments.begin(), _segments.size() - 1), _headPos};
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::position_t TypedPath<E>::_back() const {
+
+        return {_segments.begin(), _backPos};
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::position_vector_t TypedPath<E>::_body(double stopAt) const {
+
+        // return container
+        position_vector_t ret{};
+        ret.reserve(_segments.size());
+
+        // throw error
+        if (_segments.empty())
+            throw std::runtime_error("No segments");
+
+        // initialize length
+        double len = -_s;
+
+        // sum up all segments
+        for (auto it = _it; it != _segments.end(); ++it) {
+
+            // update length and add iterator and length to vector
+            len += (*it)->length();
+            ret.push_back({it, len});
+
+            // stop if stopAt is reached
+            if (len >= stopAt) {
+
+                // remove distance from end and return
+                ret.back().s -= len - stopAt;
+                return ret;
+
+            }
+
+        }
+
+        // remove distance from end and return
+        ret.back().s -= (*ret.back().it)->length() - _headPos;
+        return ret;
+
+    }
+
+
+    template<typename E>
+    typename TypedPath<E>::position_vector_t TypedPath<E>::_tail(double stopAt) const {
+
+        // return container
+        position_vector_t ret{};
+        ret.reserve(_segments.size());
+
+        // throw error
+        if (_segments.empty())
+            throw std::runtime_error("No segments");
+
+        // initialize length
+        double len = -((*_it)->length() - _s);
+
+        // get reverse iterator (but take the next one, because of the
+        // iterator shift (see https://en.cppreference.com/w/cpp/iterator/reverse_iterator)
+        auto it = std::make_reverse_iterator(std::next(_it, 1));
+
+        // sum up all segments
+        for (; it != _segments.rend(); it++) {
+
+            // update length and add iterator and length to vector
+            // save forward iterator (shift because see above)
+            len += (*it)->length();
+            ret.push_back({std::next(it, 1).base(), len});
+
+            // stop if stopAt is reached
+            if (len >= stopAt) {
+
+                // remove distance from end and return
+                ret.back().s -= len - stopAt;
+                return ret;
+
+            }
+
+        }
+
+        // remove length of last element
+        ret.back().s -= _backPos;
+        return ret;
+
+    }
+
+
+    template<typename E>
+    std::ostream &TypedPath<E>::streamTo(std::ostream &os) const {
+
+        size_t n = 0;
+
+        // iterate over edges
+        for (auto r : _segments)
+            os << (n++ == 0 ? "" : " > ") << r->id();
+
+        return os;
+
+
+    }
+
+
+    extern template class TypedPath<Edge>;
+
 }
 
 
-std::ostream & operator<<(std::ostream &os, const graph::Path& p);
+/**
+ * Streams the path to the given stream
+ * @param os Out stream
+ * @param p Path
+ * @return The stream
+ */
+template<typename E>
+std::ostream & operator<<(std::ostream &os, const graph::TypedPath<E>& p) {
+
+    return p.streamTo(os);
+
+}
 
 
 #endif // SIMMAP_GRAPH_PATH_H
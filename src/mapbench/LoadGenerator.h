@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-03.
+//
+
+
+#ifndef SIMMAP_LOADGENERATOR_H
+#define SIMMAP_LOADGENERATOR_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include <mapserver/simmap.grpc.pb.h>
+
+
+/**
+ * @brief Load generator for the map server
+ * Drives a number of virtual agents against a map server and records the latency of each call.
+ */
+class LoadGenerator {
+
+public:
+
+    using clock = std::chrono::steady_clock;
+    using Stub = ::simmap::envrionment::manager::AgentEnvironmentServer::Stub;
+
+    /** Enum to define the recorded call types (TICK is the complete tick of an agent) */
+    enum Call {
+        MOVE, HORIZON, TARGETS, LANES, TICK, N_CALLS
+    };
+
+
+    /** Struct to define the settings of the load generator */
+    struct Settings {
+        std::vector<std::string> track{};        /**< the track of the agents (road IDs) */
+        std::string edge{};                      /**< the start edge of the agents */
+        double spacing = 1.0;                    /**< the longitudinal distance between the agents on the start edge */
+        unsigned int agents = 10;                /**< the number of virtual agents */
+        unsigned int threads = 1;                /**< the number of client threads (one channel each) */
+        double rate = 0.0;                       /**< ticks per second and agent (0 = closed loop) */
+        double duration = 10.0;                  /**< the duration of the measurement in seconds */
+        double speed = 1.0;                      /**< the distance moved per tick */
+        unsigned int gridPoints = 20;            /**< the number of horizon grid points */
+        double horizonLength = 200.0;            /**< the length of the horizon */
+        bool packed = false;                     /**< request the packed horizon */
+        std::array<unsigned int, TICK> mix{{1, 1, 1, 1}}; /**< the number of calls per tick and type */
+    };
+
+
+    /** Struct to store the measured latencies (in microseconds) */
+    struct Result {
+        std::array<std::vector<double>, N_CALLS> latency{};
+        std::array<size_t, N_CALLS> errors{};
+        double duration = 0.0;
+    };
+
+
+    /**
+     * Creates the load generator
+     * @param address Address of the server
+     * @param settings Settings
+     */
+    LoadGenerator(std::string address, Settings settings)
+            : _address(std::move(address)), _settings(std::move(settings)) {}
+
+
+    /**
+     * Returns the name of the call type
+     * @param call Call type
+     * @return Name
+     */
+    static const char *callName(Call call) {
+
+        static const char *names[] = {"move", "horizon", "targets", "lanes", "tick"};
+        return names[call];
+
+    }
+
+
+    /**
+     * Loads the map on the server and registers and places the agents
+     * @param mapFile Map file (path on the server)
+     * @return Flag whether the setup was successful
+     */
+    bool setup(const std::string &mapFile) {
+
+        using namespace ::simmap::envrionment::manager;
+
+        auto stub = newStub(0);
+
+        // load map
+        MapFile file;
+        file.set_filename(mapFile);
+
+        grpc::ClientContext ctx;
+        if (!stub->loadMap(&ctx, file, &_map).ok()) {
+            std::cerr << "Could not load map " << mapFile << std::endl;
+            return false;
+        }
+
+        // wait for map
+        MapStatus status;
+        do {
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            grpc::ClientContext c;
+            if (!stub->mapStatus(&c, _map, &status).ok())
+                return false;
+
+        } while (status.status() == MapStatus_Status_LOADING);
+
+        if (status.status() != MapStatus_Status_READY) {
+            std::cerr << "Map " << mapFile << " failed to load" << std::endl;
+            return false;
+        }
+
+        // register agents
+        for (unsigned int i = 1; i <= _settings.agents; ++i) {
+
+            AgentMap am;
+            am.mutable_agent()->set_id(i);
+            am.mutable_map()->set_id(_map.id());
+
+            AgentTrack at;
+            at.mutable_agent()->set_id(i);
+            for (const auto &r : _settings.track)
+                at.mutable_track()->add_roads(r);
+
+            Void v;
+            grpc::ClientContext c1, c2;
+            if (!stub->registerAgent(&c1, am, &v).ok() || !stub->setTrack(&c2, at, &v).ok()
+                || !place(stub.get(), i)) {
+                std::cerr << "Could not register agent " << i << std::endl;
+                return false;
+            }
+
+        }
+
+        return true;
+
+    }
+
+
+    /**
+     * Runs the measurement
+     * @return Measured latencies
+     */
+    Result run() {
+
+        Result result{};
+        std::mutex mutex{};
+
+        // start threads
+        std::vector<std::thread> threads;
+        auto start = clock::now();
+        for (unsigned int w = 0; w < _settings.threads; ++w)
+            threads.emplace_back([this, w, start, &result, &mutex]() {
+
+                auto res = worker(w, start);
+
+                // merge results
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t c = 0; c < N_CALLS; ++c) {
+                    result.latency[c].insert(result.latency[c].end(), res.latency[c].begin(), res.latency[c].end());
+                    result.errors[c] += res.errors[c];
+                }
+
+            });
+
+        // wait for threads
+        for (auto &t : threads)
+            t.join();
+
+        result.duration = std::chrono::duration<double>(clock::now() - start).count();
+        return result;
+
+    }
+
+
+    /**
+     * Prints the latency percentiles and the throughput of each call type
+     * @param result Measured latencies
+     * @param os Output stream
+     */
+    static void report(Result &result, std::ostream &os) {
+
+        os << std::left << std::setw(10) << "call" << std::right
+           << std::setw(10) << "calls" << std::setw(8) << "errors" << std::setw(12) << "calls/s"
+           << std::setw(12) << "p50[us]" << std::setw(12) << "p99[us]" << std::setw(12) << "p999[us]" << std::endl;
+
+        size_t total = 0;
+        for (size_t c = 0; c < N_CALLS; ++c) {
+
+            auto &lat = result.latency[c];
+            std::sort(lat.begin(), lat.end());
+
+            if (c != TICK)
+                total += lat.size();
+
+            os << std::left << std::setw(10) << callName(static_cast<Call>(c)) << std::right << std::fixed
+               << std::setprecision(1) << std::setw(10) << lat.size() << std::setw(8) << result.errors[c]
+               << std::setw(12) << static_cast<double>(lat.size()) / result.duration
+               << std::setw(12) << percentile(lat, 0.5) << std::setw(12) << percentile(lat, 0.99)
+               << std::setw(12) << percentile(lat, 0.999) << std::endl;
+
+        }
+
+        os << "total: " << total << " calls in " << result.duration << " s ("
+           << static_cast<double>(total) / result.duration << " calls/s)" << std::endl;
+
+    }
+
+
+private:
+
+    std::string _address;
+    Settings _settings;
+    ::simmap::envrionment::manager::MapInstance _map{};
+
+
+    /**
+     * Returns the given percentile of a sorted vector
+     * @param v Sorted vector
+     * @param q Quantile (0..1)
+     * @return Percentile
+     */
+    static double percentile(const std::vector<double> &v, double q) {
+
+        if (v.empty())
+            return 0.0;
+
+        auto i = static_cast<size_t>(q * static_cast<double>(v.size()));
+        return v[std::min(i, v.size() - 1)];
+
+    }
+
+
+    /**
+     * Creates a stub with an own connection
+     * @param channel Channel index
+     * @return Stub
+     */
+    std::unique_ptr<Stub> newStub(unsigned int channel) const {
+
+        grpc::ChannelArguments args;
+        args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        args.SetInt("simmap.channel", static_cast<int>(channel));
+
+        return ::simmap::envrionment::manager::AgentEnvironmentServer::NewStub(
+                grpc::CreateCustomChannel(_address, grpc::InsecureChannelCredentials(), args));
+
+    }
+
+
+    /**
+     * Places the agent on the start edge
+     * @param stub Stub
+     * @param id Agent ID
+     * @return Flag whether the agent could be placed
+     */
+    bool place(Stub *stub, unsigned int id) const {
+
+        using namespace ::simmap::envrionment::manager;
+
+        AgentMapPosition amp;
+        amp.mutable_agent()->set_id(id);
+        amp.mutable_mapposition()->set_edgeid(_settings.edge);
+        amp.mutable_mapposition()->set_longpos((id - 1) * _settings.spacing);
+        amp.mutable_mapposition()->set_latpos(0.0);
+
+        TrackLengths tl;
+        grpc::ClientContext ctx;
+        return stub->setMapPosition(&ctx, amp, &tl).ok();
+
+    }
+
+
+    /**
+     * Drives the agents w, w + threads, w + 2 * threads, ...
+     * @param w Worker index
+     * @param start Start time of the measurement
+     * @return Measured latencies
+     */
+    Result worker(unsigned int w, clock::time_point start) {
+
+        using namespace ::simmap::envrionment::manager;
+
+        Result res{};
+        auto stub = newStub(w);
+        auto end = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(_settings.duration));
+
+        // prepare requests
+        std::vector<AgentInstance> instances;
+        std::vector<AgentDisplacement> displacements;
+        std::vector<AgentGridPoints> grids;
+
+        for (unsigned int id = w + 1; id <= _settings.agents; id += _settings.threads) {
+
+            instances.emplace_back();
+            instances.back().set_id(id);
+
+            displacements.emplace_back();
+            displacements.back().mutable_agent()->set_id(id);
+            displacements.back().set_distance(_settings.speed);
+
+            grids.emplace_back();
+            grids.back().mutable_agent()->set_id(id);
+            grids.back().set_packed(_settings.packed);
+            for (unsigned int i = 0; i < _settings.gridPoints; ++i)
+                grids.back().add_gridpoints(i * _settings.horizonLength / std::max(1u, _settings.gridPoints - 1));
+
+        }
+
+        // reserve memory for the expected number of ticks in open loop
+        if (_settings.rate > 0.0)
+            for (auto &l : res.latency)
+                l.reserve(static_cast<size_t>(_settings.rate * _settings.duration * instances.size() * 2));
+
+        // tick interval (open loop)
+        auto interval = _settings.rate > 0.0
+                        ? std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / _settings.rate))
+                        : clock::duration::zero();
+
+        for (size_t k = 0;; ++k) {
+
+            // get scheduled start of the tick (closed loop: now)
+            auto scheduled = _settings.rate > 0.0 ? start + interval * static_cast<clock::rep>(k) : clock::now();
+            if (scheduled >= end)
+                break;
+
+            // wait for the scheduled start
+            std::this_thread::sleep_until(scheduled);
+
+            for (size_t a = 0; a < instances.size(); ++a) {
+
+                for (size_t c = 0; c < TICK; ++c) {
+
+                    for (unsigned int j = 0; j < _settings.mix[c]; ++j) {
+
+                        grpc::ClientContext ctx;
+                        grpc::Status st;
+
+                        auto t0 = clock::now();
+
+                        // execute call
+                        if (c == MOVE) {
+                            TrackLengths tl;
+                            st = stub->move(&ctx, displacements[a], &tl);
+                        } else if (c == HORIZON) {
+                            Horizon hor;
+                            st = stub->horizon(&ctx, grids[a], &hor);
+                        } else if (c == TARGETS) {
+                            TargetList tl;
+                            st = stub->targets(&ctx, instances[a], &tl);
+                        } else {
+                            LaneList ll;
+                            st = stub->lanes(&ctx, instances[a], &ll);
+                        }
+
+                        auto t1 = clock::now();
+
+                        // record latency
+                        if (!st.ok()) {
+
+                            res.errors[c]++;
+
+                            // reset agent at end of track
+                            if (c == MOVE)
+                                place(stub.get(), instances[a].id());
+
+                        } else {
+
+                            res.latency[c].push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+
+                        }
+
+                    }
+
+                }
+
+                // record tick (measured from the scheduled start to include queueing in open loop)
+                res.latency[TICK].push_back(std::chrono::duration<double, std::micro>(clock::now() - scheduled).count());
+
+            }
+
+        }
+
+        return res;
+
+    }
+
+};
+
+
+#endif //SIMMAP_LOADGENERATOR_H
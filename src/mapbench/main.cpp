@@ -0,0 +1,128 @@
+#include <mapserver/AgentEnvironmentSrv.h>
+#include "LoadGenerator.h"
+#include <cxxopts.hpp>
+
+int main(int argc, char **argv) {
+
+    // set options
+    cxxopts::Options options("SimMap gRPC benchmark", "This client drives virtual agents against a SimMap server.");
+    options.add_options()
+            ("a,address", "Address of the server, an in-process server is started if not set",
+             cxxopts::value<std::string>()->default_value(""))
+            ("f,file", "Map file (OpenDRIVE), required", cxxopts::value<std::string>())
+            ("t,track", "Track of the agents (road IDs, comma separated), required",
+             cxxopts::value<std::vector<std::string>>())
+            ("e,edge", "Start edge of the agents, required", cxxopts::value<std::string>())
+            ("s,spacing", "Distance between the agents on the start edge (default: 1.0)",
+             cxxopts::value<double>()->default_value("1.0"))
+            ("n,agents", "Number of virtual agents (default: 10)",
+             cxxopts::value<unsigned int>()->default_value("10"))
+            ("j,threads", "Number of client threads (default: 1)",
+             cxxopts::value<unsigned int>()->default_value("1"))
+            ("m,mix", "Calls per tick, e.g. move=1,horizon=1,targets=1,lanes=1",
+             cxxopts::value<std::vector<std::string>>()->default_value("move=1,horizon=1,targets=1,lanes=1"))
+            ("r,rate", "Ticks per second and agent, 0 for closed loop (default: 0)",
+             cxxopts::value<double>()->default_value("0.0"))
+            ("d,duration", "Duration of the measurement in seconds (default: 10)",
+             cxxopts::value<double>()->default_value("10.0"))
+            ("v,speed", "Distance moved per tick (default: 1.0)",
+             cxxopts::value<double>()->default_value("1.0"))
+            ("g,grid", "Number of horizon grid points (default: 20)",
+             cxxopts::value<unsigned int>()->default_value("20"))
+            ("packed", "Request the packed horizon")
+            ("h,help", "Show help");
+
+    // parse result
+    auto result = options.parse(argc, argv);
+
+    // print help and end
+    if (result.count("help")) {
+        std::cout << options.help() << std::endl;
+        exit(0);
+    }
+
+    // check required options
+    if (!result.count("file") || !result.count("track") || !result.count("edge")) {
+        std::cerr << "Error: Please provide map file, track and start edge." << std::endl;
+        return 1;
+    }
+
+    // settings
+    LoadGenerator::Settings settings;
+    settings.track = result["track"].as<std::vector<std::string>>();
+    settings.edge = result["edge"].as<std::string>();
+    settings.spacing = result["spacing"].as<double>();
+    settings.agents = result["agents"].as<unsigned int>();
+    settings.threads = std::max(1u, result["threads"].as<unsigned int>());
+    settings.rate = result["rate"].as<double>();
+    settings.duration = result["duration"].as<double>();
+    settings.speed = result["speed"].as<double>();
+    settings.gridPoints = result["grid"].as<unsigned int>();
+    settings.packed = result.count("packed") != 0;
+
+    // parse call mix
+    settings.mix.fill(0);
+    for (const auto &m : result["mix"].as<std::vector<std::string>>()) {
+
+        auto pos = m.find('=');
+        auto name = m.substr(0, pos);
+        auto count = pos == std::string::npos ? 1 : std::stoi(m.substr(pos + 1));
+
+        // find call type
+        size_t c = 0;
+        while (c < LoadGenerator::TICK && name != LoadGenerator::callName(static_cast<LoadGenerator::Call>(c)))
+            ++c;
+
+        if (c == LoadGenerator::TICK) {
+            std::cerr << "Error: Unknown call " << name << "." << std::endl;
+            return 1;
+        }
+
+        settings.mix[c] = static_cast<unsigned int>(count);
+
+    }
+
+    // start in-process server
+    auto address = result["address"].as<std::string>();
+    std::unique_ptr<AgentEnvironmentSrv> service;
+    std::unique_ptr<Server> server;
+
+    if (address.empty()) {
+
+        // create service
+        service.reset(new AgentEnvironmentSrv(std::vector<std::string>{}));
+
+        // build server on a free port
+        int port = 0;
+        ServerBuilder builder;
+        builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+        builder.RegisterService(service.get());
+
+        // measure RPCs
+        std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+        interceptors.emplace_back(service->interceptorFactory());
+        builder.experimental().SetInterceptorCreators(std::move(interceptors));
+
+        server = builder.BuildAndStart();
+
+        address = "127.0.0.1:" + std::to_string(port);
+        std::cout << "In-process server listening on " << address << std::endl;
+
+    }
+
+    // setup agents
+    LoadGenerator generator(address, settings);
+    if (!generator.setup(result["file"].as<std::string>()))
+        return 1;
+
+    // run and print results
+    auto res = generator.run();
+    LoadGenerator::report(res, std::cout);
+
+    // stop server
+    if (server)
+        server->Shutdown();
+
+    return 0;
+
+}
@@ -28,14 +28,22 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
+#include <mutex>
+#include <sstream>
 
 #include <grpc/grpc.h>
 #include <grpcpp/server.h>
 #include <grpcpp/server_builder.h>
 #include <grpcpp/server_context.h>
 #include <mapserver/simmap.grpc.pb.h>
+#include <mapserver/MetricsInterceptor.h>
 #include <simmap/simmap.h>
 
+#ifndef MAX_LIST_ELEMENTS
+#define MAX_LIST_ELEMENTS 256
+#endif
+
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
@@ -48,19 +56,79 @@ using std::chrono::system_clock;
 
 class AgentEnvironmentSrv final : public simmap::envrionment::manager::AgentEnvironmentServer::Service {
 
-    unsigned long map_id{};
+    std::mutex _mutex{};
+    RpcMetrics _rpcMetrics{};
+
+
+    /**
+     * Returns a thread local scratch buffer with at least n elements. The buffer is reused by subsequent calls
+     * @tparam T Type of the elements
+     * @param n Number of elements
+     * @return Pointer to the first element
+     */
+    template<typename T>
+    static T *buffer(size_t n) {
+
+        static thread_local std::vector<T> buf{};
+
+        // grow buffer
+        if (buf.size() < n)
+            buf.resize(n);
+
+        return buf.data();
+
+    }
 
 public:
 
     /**
      * @brief Starts the service
-     * Loads a given map into the memory.
-     * @param map
+     * Starts loading the given maps in the background. The maps get the IDs 1..n in the given order.
+     * @param maps Map files to be prewarmed
      */
-    explicit AgentEnvironmentSrv(const std::string &map) {
+    explicit AgentEnvironmentSrv(const std::vector<std::string> &maps) {
+
+        // load maps
+        for (const auto &map : maps) {
+
+            unsigned long id;
+            simmap::loadMapAsync(map.c_str(), id);
 
-        // load map
-        simmap::loadMap(map.c_str(), map_id);
+        }
+
+    }
+
+
+    /**
+     * Creates an interceptor factory to measure the RPCs of this service
+     * @return Interceptor factory
+     */
+    std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface> interceptorFactory() {
+
+        return std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>(
+                new MetricsInterceptorFactory(&_rpcMetrics));
+
+    }
+
+
+    /**
+     * Returns the metrics of the RPCs and the library in the Prometheus text format
+     * @return Metrics text
+     */
+    std::string metrics() const {
+
+        std::stringstream ss{};
+        _rpcMetrics.write(ss);
+
+        // get library metrics
+        unsigned long n = 0;
+        simmap::metrics(nullptr, n);
+
+        std::vector<char> text(n);
+        if (simmap::metrics(text.data(), n) == 0)
+            ss << text.data();
+
+        return ss.str();
 
     }
 
@@ -70,16 +138,154 @@ public:
      */
     ~AgentEnvironmentSrv() override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // reset everything
         simmap::clear();
 
     }
 
+    Status clear(::grpc::ServerContext *context, const ::simmap::envrionment::manager::Void *request,
+                 ::simmap::envrionment::manager::Void *response) override {
+
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // execute
+        if (simmap::clear() != 0)
+            return Status::CANCELLED;
+
+        // ok
+        return Status::OK;
+
+    }
+
+    Status loadMap(::grpc::ServerContext *context, const ::simmap::envrionment::manager::MapFile *request,
+                   ::simmap::envrionment::manager::MapInstance *response) override {
+
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // execute (the map is loaded in background, see mapStatus)
+        unsigned long id;
+        if (simmap::loadMapAsync(request->filename().c_str(), id) != 0)
+            return Status::CANCELLED;
+
+        // set response
+        response->set_id(id);
+
+        // ok
+        return Status::OK;
+
+    }
+
+    Status unloadMap(::grpc::ServerContext *context, const ::simmap::envrionment::manager::MapInstance *request,
+                     ::simmap::envrionment::manager::Void *response) override {
+
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // execute
+        if (simmap::unloadMap(request->id()) != 0)
+            return Status::CANCELLED;
+
+        // ok
+        return Status::OK;
+
+    }
+
+    Status mapStatus(::grpc::ServerContext *context, const ::simmap::envrionment::manager::MapInstance *request,
+                     ::simmap::envrionment::manager::MapStatus *response) override {
+
+        // namespace
+        using namespace ::simmap::envrionment::manager;
+
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // execute
+        simmap::MapStatus status{};
+        if (simmap::mapStatus(request->id(), status) != 0)
+            return Status::CANCELLED;
+
+        // map status
+        auto st = MapStatus_Status_LOADING;
+        if (status == simmap::MapStatus::READY)
+            st = MapStatus_Status_READY;
+        else if (status == simmap::MapStatus::FAILED)
+            st = MapStatus_Status_FAILED;
+
+        // set response
+        response->mutable_map()->set_id(request->id());
+        response->set_status(st);
+
+        // ok
+        return Status::OK;
+
+    }
+
+    Status stats(::grpc::ServerContext *context, const ::simmap::envrionment::manager::Void *request,
+                 ::simmap::envrionment::manager::Statistics *response) override {
+
+        // RPC statistics
+        auto &calls = _rpcMetrics.calls();
+        for (size_t i = 0; i < calls.size(); ++i) {
+
+            auto &c = calls.at(i);
+            auto n = c.calls.load(std::memory_order_relaxed);
+
+            auto st = response->add_rpc();
+            st->set_name(calls.name(i));
+            st->set_calls(n);
+            st->set_errors(c.errors.load(std::memory_order_relaxed));
+            st->set_meanlatency(n == 0 ? 0.0 : c.latency.sum() / static_cast<double>(n));
+            st->set_p50latency(c.latency.quantile(0.5));
+            st->set_p99latency(c.latency.quantile(0.99));
+            st->set_p999latency(c.latency.quantile(0.999));
+
+        }
+
+        // library statistics
+        unsigned long n = 64;
+        auto libStats = buffer<simmap::CallStatistics>(n);
+        if (simmap::statistics(libStats, n) != 0)
+            return Status::CANCELLED;
+
+        for (size_t i = 0; i < n; ++i) {
+
+            auto st = response->add_library();
+            st->set_name(libStats[i].name);
+            st->set_calls(libStats[i].calls);
+            st->set_errors(libStats[i].errors);
+            st->set_meanlatency(libStats[i].meanLatency);
+            st->set_p50latency(libStats[i].p50Latency);
+            st->set_p99latency(libStats[i].p99Latency);
+            st->set_p999latency(libStats[i].p999Latency);
+
+        }
+
+        // complete metrics
+        response->set_metrics(metrics());
+
+        // ok
+        return Status::OK;
+
+    }
+
     Status registerAgent(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentMap *request,
                          ::simmap::envrionment::manager::Void *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // execute
-        if (simmap::registerAgent(request->agent().id(), request->map().id()) != 0)
+        auto err = simmap::registerAgent(request->agent().id(), request->map().id());
+
+        // map is not loaded yet, retry later
+        if (err == 47)
+            return Status(grpc::StatusCode::UNAVAILABLE, "map is still loading");
+        else if (err != 0)
             return Status::CANCELLED;
 
         // ok
@@ -90,6 +296,9 @@ public:
     Status unregisterAgent(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentInstance *request,
                            ::simmap::envrionment::manager::Void *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // execute
         if (simmap::unregisterAgent(request->id()) != 0)
             return Status::CANCELLED;
@@ -102,9 +311,12 @@ public:
     Status setTrack(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentTrack *request,
                     ::simmap::envrionment::manager::Void *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare track
         auto n = request->track().roads_size();
-        const char *roads[n];
+        auto roads = buffer<const char *>(n);
 
         // set elements
         for (int i = 0; i < n; ++i)
@@ -122,6 +334,9 @@ public:
     Status getPosition(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentInstance *request,
                        ::simmap::envrionment::manager::Position *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare data
         simmap::Position pos{};
 
@@ -145,6 +360,9 @@ public:
     setMapPosition(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentMapPosition *request,
                    ::simmap::envrionment::manager::TrackLengths *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare map position
         simmap::MapPosition mapPos{};
         mapPos.edgeID = request->mapposition().edgeid().c_str();
@@ -170,6 +388,9 @@ public:
     Status getMapPosition(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentInstance *request,
                           ::simmap::envrionment::manager::MapPosition *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare map position
         simmap::MapPosition mapPos{};
 
@@ -190,6 +411,9 @@ public:
     Status match(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentPositionUpdate *request,
                  ::simmap::envrionment::manager::MapPosition *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare input data
         simmap::Position pos{};
         pos.x = request->position().x();
@@ -218,6 +442,9 @@ public:
     Status move(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentDisplacement *request,
                 ::simmap::envrionment::manager::TrackLengths *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // variables
         double lenFront{}, lenBack{};
 
@@ -238,6 +465,9 @@ public:
     Status switchLane(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentLane *request,
                       ::simmap::envrionment::manager::Void *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // execute
         if (simmap::switchLane(request->agent().id(), request->laneoffset()) != 0)
             return Status::CANCELLED;
@@ -250,14 +480,40 @@ public:
     Status horizon(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentGridPoints *request,
                    ::simmap::envrionment::manager::Horizon *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare horizon
         auto n = request->gridpoints_size();
-        simmap::HorizonInformation hor[n];
+
+        // packed horizon: the library writes directly into the packed values of the response
+        if (request->packed()) {
+
+            static_assert(sizeof(simmap::HorizonInformation) == 8 * sizeof(double),
+                          "HorizonInformation must consist of 8 doubles");
+
+            // allocate values
+            auto values = response->mutable_values();
+            values->Resize(8 * n, 0.0);
+
+            // execute
+            auto hor = reinterpret_cast<simmap::HorizonInformation *>(values->mutable_data());
+            if (simmap::horizon(request->agent().id(), request->gridpoints().data(), hor, n) != 0)
+                return Status::CANCELLED;
+
+            // ok
+            return Status::OK;
+
+        }
 
         // execute
+        auto hor = buffer<simmap::HorizonInformation>(n);
         if (simmap::horizon(request->agent().id(), request->gridpoints().data(), hor, n) != 0)
             return Status::CANCELLED;
 
+        // allocate points
+        response->mutable_point()->Reserve(n);
+
         // iterate over horizon points
         for (int i = 0; i < n; ++i) {
 
@@ -284,17 +540,24 @@ public:
     Status objects(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentInstance *request,
                    ::simmap::envrionment::manager::ObjectList *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // namespace
         using namespace ::simmap::envrionment::manager;
 
         // prepare object list
-        unsigned long n = response->maxnoofelements();
-        simmap::ObjectInformation objects[n];
+        unsigned long n = MAX_LIST_ELEMENTS;
+        auto objects = buffer<simmap::ObjectInformation>(n);
 
         // execute
         if (simmap::objects(request->id(), objects, n) != 0)
             return Status::CANCELLED;
 
+        // allocate elements
+        response->set_maxnoofelements(MAX_LIST_ELEMENTS);
+        response->mutable_object()->Reserve(n);
+
         // iterate over horizon points
         for (int i = 0; i < n; ++i) {
 
@@ -324,17 +587,24 @@ public:
     Status lanes(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentInstance *request,
                  ::simmap::envrionment::manager::LaneList *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // namespace
         using namespace ::simmap::envrionment::manager;
 
         // prepare lane list
-        unsigned long n = response->maxnoofelements();
-        simmap::LaneInformation lanes[n];
+        unsigned long n = MAX_LIST_ELEMENTS;
+        auto lanes = buffer<simmap::LaneInformation>(n);
 
         // execute
         if (simmap::lanes(request->id(), lanes, n) != 0)
             return Status::CANCELLED;
 
+        // allocate elements
+        response->set_maxnoofelements(MAX_LIST_ELEMENTS);
+        response->mutable_lane()->Reserve(n);
+
         // iterate over horizon points
         for (int i = 0; i < n; ++i) {
 
@@ -372,14 +642,21 @@ public:
     Status targets(::grpc::ServerContext *context, const ::simmap::envrionment::manager::AgentInstance *request,
                    ::simmap::envrionment::manager::TargetList *response) override {
 
+        // lock library
+        std::lock_guard<std::mutex> lock(_mutex);
+
         // prepare target list
-        unsigned long n = response->maxnoofelements();
-        simmap::TargetInformation targets[n];
+        unsigned long n = MAX_LIST_ELEMENTS;
+        auto targets = buffer<simmap::TargetInformation>(n);
 
         // execute
         if (simmap::targets(request->id(), targets, n) != 0)
             return Status::CANCELLED;
 
+        // allocate elements
+        response->set_maxnoofelements(MAX_LIST_ELEMENTS);
+        response->mutable_target()->Reserve(n);
+
         // iterate over horizon points
         for (int i = 0; i < n; ++i) {
 
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-05.
+//
+
+
+#ifndef SIMMAP_METRICSENDPOINT_H
+#define SIMMAP_METRICSENDPOINT_H
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+/**
+ * @brief Minimal HTTP endpoint serving metrics in the Prometheus text format
+ * Every request is answered with the text of the provider, the requests are handled sequentially in an own thread.
+ */
+class MetricsEndpoint {
+
+    int _socket = -1;
+    std::thread _thread{};
+    std::function<std::string()> _provider;
+
+    void serve() {
+
+        char buffer[4096];
+
+        while (true) {
+
+            // wait for connection (fails when the socket is shut down)
+            int con = accept(_socket, nullptr, nullptr);
+            if (con < 0)
+                break;
+
+            // read request (the content is not evaluated)
+            recv(con, buffer, sizeof(buffer), 0);
+
+            // create response
+            auto body = _provider();
+            auto response = std::string("HTTP/1.1 200 OK\r\n")
+                            + "Content-Type: text/plain; version=0.0.4\r\n"
+                            + "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                            + "Connection: close\r\n\r\n" + body;
+
+            // send response
+            size_t sent = 0;
+            while (sent < response.size()) {
+
+                auto n = send(con, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0)
+                    break;
+
+                sent += static_cast<size_t>(n);
+
+            }
+
+            close(con);
+
+        }
+
+    }
+
+public:
+
+    /**
+     * Starts the endpoint
+     * @param host Host address (IPv4)
+     * @param port Port
+     * @param provider Function to provide the metrics text
+     */
+    MetricsEndpoint(const std::string &host, int port, std::function<std::string()> provider)
+            : _provider(std::move(provider)) {
+
+        // create address
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+            throw std::invalid_argument("Invalid metrics host " + host);
+
+        // create socket
+        _socket = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        // bind and listen
+        if (bind(_socket, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(_socket, 16) != 0) {
+            close(_socket);
+            throw std::runtime_error("Could not open metrics endpoint on port " + std::to_string(port));
+        }
+
+        // start thread
+        _thread = std::thread([this]() { serve(); });
+
+    }
+
+
+    /**
+     * Stops the endpoint
+     */
+    ~MetricsEndpoint() {
+
+        shutdown(_socket, SHUT_RDWR);
+        close(_socket);
+        _thread.join();
+
+    }
+
+};
+
+
+#endif //SIMMAP_METRICSENDPOINT_H
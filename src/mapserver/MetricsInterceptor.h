@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-05.
+//
+
+
+#ifndef SIMMAP_METRICSINTERCEPTOR_H
+#define SIMMAP_METRICSINTERCEPTOR_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/descriptor.h>
+#include <grpcpp/support/server_interceptor.h>
+#include <mapserver/simmap.grpc.pb.h>
+#include <base/metrics.h>
+
+
+/**
+ * @brief Metrics of all RPCs of the map server
+ * The RPCs are taken from the service descriptor, the table is not changed after construction.
+ */
+class RpcMetrics {
+
+    base::metrics::CallTable _calls;
+    base::metrics::CodeCounter<17> _status{}; // gRPC status code -> number of occurrences
+    std::map<std::string, size_t> _index{};   // full method name -> index in table
+
+    static std::vector<std::string> methods() {
+
+        using namespace ::simmap::envrionment::manager;
+
+        // get service
+        auto service = google::protobuf::DescriptorPool::generated_pool()->FindServiceByName(
+                AgentEnvironmentServer::service_full_name());
+
+        std::vector<std::string> names;
+        for (int i = 0; service != nullptr && i < service->method_count(); ++i)
+            names.emplace_back(service->method(i)->name());
+
+        return names;
+
+    }
+
+public:
+
+    using clock = base::metrics::CallTable::clock;
+
+
+    RpcMetrics() : _calls(methods()) {
+
+        using namespace ::simmap::envrionment::manager;
+
+        // create index by full method name
+        for (size_t i = 0; i < _calls.size(); ++i)
+            _index[std::string("/") + AgentEnvironmentServer::service_full_name() + "/" + _calls.name(i)] = i;
+
+    }
+
+
+    /**
+     * Returns the call table
+     * @return Call table
+     */
+    const base::metrics::CallTable &calls() const {
+
+        return _calls;
+
+    }
+
+
+    /**
+     * Records a finished RPC
+     * @param method Full method name
+     * @param start Start time of the RPC
+     * @param code Status code
+     */
+    void record(const char *method, clock::time_point start, grpc::StatusCode code) {
+
+        _status.increment(static_cast<size_t>(code));
+
+        // record RPC
+        auto it = _index.find(method);
+        if (it != _index.end())
+            _calls.record(it->second, start, code != grpc::StatusCode::OK);
+
+    }
+
+
+    /**
+     * Writes the metrics in the Prometheus text format
+     * @param os Output stream
+     */
+    void write(std::ostream &os) const {
+
+        _calls.write(os, "mapserver_rpc", "method");
+        _status.write(os, "mapserver_rpc_status_total", "code");
+
+    }
+
+};
+
+
+/**
+ * @brief Interceptor to measure a single RPC
+ */
+class MetricsInterceptor : public grpc::experimental::Interceptor {
+
+    RpcMetrics *_metrics;
+    const char *_method;
+    RpcMetrics::clock::time_point _start;
+
+public:
+
+    MetricsInterceptor(RpcMetrics *metrics, const char *method)
+            : _metrics(metrics), _method(method), _start(RpcMetrics::clock::now()) {}
+
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods *methods) override {
+
+        using grpc::experimental::InterceptionHookPoints;
+
+        // record when the status is sent
+        if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS))
+            _metrics->record(_method, _start, methods->GetSendStatus().error_code());
+
+        methods->Proceed();
+
+    }
+
+};
+
+
+/**
+ * @brief Factory to create the metrics interceptors, to be registered at the server builder
+ */
+class MetricsInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+
+    RpcMetrics *_metrics;
+
+public:
+
+    explicit MetricsInterceptorFactory(RpcMetrics *metrics) : _metrics(metrics) {}
+
+
+    grpc::experimental::Interceptor *CreateServerInterceptor(grpc::experimental::ServerRpcInfo *info) override {
+
+        return new MetricsInterceptor(_metrics, info->method());
+
+    }
+
+};
+
+
+#endif //SIMMAP_METRICSINTERCEPTOR_H
@@ -1,4 +1,5 @@
 #include "AgentEnvironmentSrv.h"
+#include "MetricsEndpoint.h"
 #include <cxxopts.hpp>
 
 int main(int argc, char **argv) {
@@ -10,7 +11,10 @@ int main(int argc, char **argv) {
              cxxopts::value<std::string>()->default_value("0.0.0.0"))
             ("p,port", "The port to be used for the server (default: 50051)",
              cxxopts::value<std::string>()->default_value("50051"))
-            ("f,file", "Map file name (and OpenDRIVE file), required", cxxopts::value<std::string>())
+            ("f,file", "Map files (OpenDRIVE) to be loaded at startup, comma separated or repeated",
+             cxxopts::value<std::vector<std::string>>())
+            ("m,metrics", "The port of the metrics endpoint, 0 to disable (default: 9464)",
+             cxxopts::value<int>()->default_value("9464"))
             ("h,help", "Show help");
 
     // parse result
@@ -22,34 +26,47 @@ int main(int argc, char **argv) {
         exit(0);
     }
 
-    // get file name
-    std::string mapFile;
-    if (result.count("file")) {
-
-        // get map file
-        mapFile = result["file"].as<std::string>();
-
-    } else {
-
-        // error and end
-        std::cerr << "Error: Please provide file OpenDRIVE filename." << std::endl;
-        return 1;
-
-    }
+    // get file names (maps can also be loaded via RPC later)
+    std::vector<std::string> mapFiles;
+    if (result.count("file"))
+        mapFiles = result["file"].as<std::vector<std::string>>();
 
     // concat server address
     auto server_address(result["name"].as<std::string>());
     server_address += ":";
     server_address += result["port"].as<std::string>();
 
-    // create service (and load map)
-    AgentEnvironmentSrv service(mapFile);
+    // create service (and start loading the maps)
+    AgentEnvironmentSrv service(mapFiles);
 
     // server builder
     ServerBuilder builder;
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
     builder.RegisterService(&service);
 
+    // measure RPCs
+    std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+    interceptors.emplace_back(service.interceptorFactory());
+    builder.experimental().SetInterceptorCreators(std::move(interceptors));
+
+    // start metrics endpoint (before the server, to end cleanly on a bad host or a used port)
+    std::unique_ptr<MetricsEndpoint> endpoint;
+    auto metricsPort = result["metrics"].as<int>();
+    if (metricsPort != 0) {
+
+        try {
+            endpoint.reset(new MetricsEndpoint(result["name"].as<std::string>(), metricsPort,
+                                               [&service]() { return service.metrics(); }));
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            exit(1);
+        }
+
+        std::cout << "Metrics available on " << result["name"].as<std::string>() << ":" << metricsPort
+                  << "/metrics" << std::endl;
+
+    }
+
     // create server
     std::unique_ptr<Server> server(builder.BuildAndStart());
     std::cout << "Server listening on " << server_address << std::endl;
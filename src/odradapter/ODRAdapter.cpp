@@ -63,7 +63,7 @@ void parseSignals(ODRRoad *road, const odr1_5::t_road &rd);
 namespace simmap {
 namespace odra {
 
-    void ODRAdapter::loadFile(const std::string &filename) {
+    void ODRAdapter::loadFile(const std::string &filename, double curveTolerance, bool hierarchy) {
 
         // create indexes
         std::map<std::string, std::shared_ptr<ODREdge>> _edges;
@@ -91,6 +91,11 @@ namespace odra {
             parseCurve(ptr.get(), r);
             parseLaneOffset(ptr.get(), r);
 
+            // pack road curve into contiguous storage and bake it
+            ptr->_curve->pack();
+            if (curveTolerance > 0.0)
+                ptr->_curve->bake(curveTolerance);
+
             // parse edges
             parseLaneSections(_edges, r, _roads);
 
@@ -123,6 +128,18 @@ namespace odra {
                 *reinterpret_cast<std::map<std::string, std::shared_ptr<graph::Edge>> *>(&_roads)
         )};
 
+        // create handles
+        this->index();
+
+        // create lane polylines and the spatial index of the polylines
+        this->_laneTessellation.build(this->_laneNetwork);
+        this->_laneIndex.build(this->_laneTessellation);
+
+        // load routing hierarchy from cache or create and cache it
+        if (hierarchy && !this->_hierarchy.load(filename + ".ch", this->_laneNetwork)) {
+            this->_hierarchy.build(this->_laneNetwork);
+            this->_hierarchy.save(filename + ".ch");
+        }
 
     }
 
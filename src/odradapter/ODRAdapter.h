@@ -56,8 +56,11 @@ namespace odra {
         /**
          * Loads the xodr file
          * @param filename Name of the file
+         * @param curveTolerance Tolerance of the baked road curves (0 = exact evaluation, see Curve::bake)
+         * @param hierarchy Flag to create the contraction hierarchies for the routing (loaded from or saved to the
+         * file name with the extension .ch)
          */
-        void loadFile(const std::string &filename);
+        void loadFile(const std::string &filename, double curveTolerance = 0.0, bool hierarchy = false);
 
     };
 
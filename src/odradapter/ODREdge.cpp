@@ -62,6 +62,29 @@ base::CurvePoint ODREdge::position(double s, base::Reference ref, double d) cons
 }
 
 
+double ODREdge::project(const base::Vector3 &xyz, double &d, double s) const {
+
+    // project on the reference line of the road
+    double t = 0.0;
+    auto sr = _road->_curve->project(xyz, t, sRoad(std::max(0.0, std::min(length(), s))));
+
+    // limit to the lane section
+    if (sr < _s0 || sr > _s1) {
+
+        sr = std::max(_s0, std::min(_s1, sr));
+        t = base::toLocal(_road->_curve->operator()(sr), xyz).y;
+
+    }
+
+    // transform into lane coordinates
+    s = isForward() ? sr - _s0 : _s1 - sr;
+    d = (isForward() ? t : -t) - offset(s, base::Reference::CENTER, 0.0);
+
+    return s;
+
+}
+
+
 const ODREdge *ODREdge::inner() const {
 
     return _inner;
@@ -66,6 +66,8 @@ struct ODREdge : public simmap::server::LaneEdge {
 
     double width(double s) const override;
 
+    double project(const base::Vector3 &xyz, double &d, double s) const override;
+
     double length() const override;
 
     base::Orientation orientation() const override;
@@ -42,7 +42,7 @@ struct ODRRoad : public graph::Edge {
     LaneSectionSequence lanes{};
     double _length = 0;
 
-    static std::vector<std::shared_ptr<ODRObject>> _objVector;
+    std::vector<std::shared_ptr<ODRObject>> _objVector{};
     ObjectsList _objects{};
 
 
@@ -29,8 +29,6 @@
 #include "ODRRoad.h"
 #include "ODREdge.h"
 
-std::vector<std::shared_ptr<ODRObject>> ODRRoad::_objVector{};
-
 void sv(ODREdge* edge, double sRoad, const ODRObject *sig) {
 
     // calculate distance from edge start
@@ -107,7 +105,7 @@ void parseSignals(ODRRoad *road, const odr1_5::t_road &rd) {
             road->_objects.emplace_back(std::pair<double, const ODRObject*>{s, obj.get()});
 
             // add to general list and index
-            ODRRoad::_objVector.emplace_back(obj);
+            road->_objVector.emplace_back(obj);
             index[obj->getID()] = obj.get();
 
         }
@@ -165,7 +163,7 @@ void parseSignals(ODRRoad *road, const odr1_5::t_road &rd) {
             road->_objects.emplace_back(std::pair<double, const ODRObject*>{s, obj.get()});
 
             // add object to object list
-            ODRRoad::_objVector.emplace_back(obj);
+            road->_objVector.emplace_back(obj);
 
 
         }
@@ -0,0 +1,548 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-19.
+//
+
+#include "ContractionHierarchy.h"
+#include "LaneEdge.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+
+namespace simmap {
+namespace server {
+
+
+    const size_t ContractionHierarchy::NONE = std::numeric_limits<size_t>::max();
+
+
+    /** Type definition of a queue entry (cost and node) */
+    typedef std::pair<double, size_t> entry_t;
+
+    /** Type definition of a min-queue */
+    typedef std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> queue_t;
+
+
+    void ContractionHierarchy::_collect(const graph::Graph &laneNetwork, std::vector<std::map<size_t, double>> &arcs) {
+
+        _nodes.clear();
+        _index.clear();
+
+        // returns the index of the node (adds the node if not existing)
+        auto node = [this](const Track::TrackElement &te) {
+
+            auto it = _index.find(te);
+            if (it != _index.end())
+                return it->second;
+
+            _index[te] = _nodes.size();
+            _nodes.push_back(te);
+
+            return _nodes.size() - 1;
+
+        };
+
+        arcs.clear();
+        for (const auto &e : laneNetwork) {
+
+            auto edge = dynamic_cast<const LaneEdge *>(e.second.get());
+            if (edge == nullptr || edge->trackElement().second == nullptr)
+                continue;
+
+            auto u = node(edge->trackElement());
+            arcs.resize(_nodes.size());
+
+            // add arcs to the roads of the successors (weighted by the length of the road)
+            for (const auto &c : edge->nexts()) {
+
+                auto next = dynamic_cast<const LaneEdge *>(c.second);
+                if (next == nullptr || next->trackElement().second == nullptr
+                    || next->trackElement() == edge->trackElement())
+                    continue;
+
+                auto v = node(next->trackElement());
+                arcs.resize(_nodes.size());
+
+                arcs[u][v] = _nodes[u].second->length();
+
+            }
+
+        }
+
+        // hash of the arcs (FNV-1a of the source, the target and the bits of the weight, sorted by source and target)
+        _fingerprint = 14695981039346656037ull;
+        auto hash = [this](uint64_t value) {
+            for (size_t i = 0; i < 8; ++i) {
+                _fingerprint ^= (value >> (8 * i)) & 0xffu;
+                _fingerprint *= 1099511628211ull;
+            }
+        };
+
+        for (size_t u = 0; u < arcs.size(); ++u) {
+            for (const auto &a : arcs[u]) {
+
+                uint64_t bits = 0;
+                std::memcpy(&bits, &a.second, sizeof(bits));
+
+                hash(u);
+                hash(a.first);
+                hash(bits);
+
+            }
+        }
+
+    }
+
+
+    void ContractionHierarchy::build(const graph::Graph &laneNetwork) {
+
+        // collect nodes and arcs
+        std::vector<std::map<size_t, double>> arcs{};
+        _collect(laneNetwork, arcs);
+
+        auto n = _nodes.size();
+
+        // create working graph
+        std::vector<std::map<size_t, Arc>> out(n), in(n);
+        auto add = [&out, &in](size_t u, size_t v, double w, size_t m) {
+
+            if (u == v)
+                return;
+
+            auto it = out[u].find(v);
+            if (it != out[u].end() && it->second.weight <= w)
+                return;
+
+            out[u][v] = Arc{v, w, m};
+            in[v][u] = Arc{u, w, m};
+
+        };
+
+        for (size_t u = 0; u < n; ++u) {
+            for (const auto &a : arcs[u])
+                add(u, a.first, a.second, NONE);
+        }
+
+        // searches witness paths from u (ignoring v) up to the given cost
+        std::map<size_t, double> dist{};
+        auto witness = [&out, &dist](size_t u, size_t v, double maxCost) {
+
+            dist.clear();
+            dist[u] = 0.0;
+
+            queue_t queue{};
+            queue.push({0.0, u});
+
+            size_t settled = 0;
+            while (!queue.empty() && settled < CONTRACTION_HIERARCHY_WITNESS_LIMIT) {
+
+                auto e = queue.top();
+                queue.pop();
+
+                if (e.first > dist.at(e.second))
+                    continue;
+
+                if (e.first > maxCost)
+                    break;
+
+                ++settled;
+                for (const auto &a : out[e.second]) {
+
+                    if (a.first == v)
+                        continue;
+
+                    auto c = e.first + a.second.weight;
+                    auto it = dist.find(a.first);
+                    if (it == dist.end() || c < it->second) {
+                        dist[a.first] = c;
+                        queue.push({c, a.first});
+                    }
+
+                }
+
+            }
+
+        };
+
+        // calculates the shortcuts to contract v (and adds them if requested)
+        auto shortcuts = [&out, &in, &add, &witness, &dist](size_t v, bool apply) {
+
+            double maxOut = 0.0;
+            for (const auto &b : out[v])
+                maxOut = std::max(maxOut, b.second.weight);
+
+            int count = 0;
+            for (const auto &a : in[v]) {
+
+                witness(a.first, v, a.second.weight + maxOut);
+
+                for (const auto &b : out[v]) {
+
+                    if (b.first == a.first)
+                        continue;
+
+                    // check witness
+                    auto c = a.second.weight + b.second.weight;
+                    auto it = dist.find(b.first);
+                    if (it != dist.end() && it->second <= c)
+                        continue;
+
+                    ++count;
+                    if (apply)
+                        add(a.first, b.first, c, v);
+
+                }
+
+            }
+
+            return count;
+
+        };
+
+        // priority of the node (edge difference and contracted neighbors)
+        std::vector<int> deleted(n, 0);
+        auto priority = [&](size_t v) {
+            return shortcuts(v, false) - static_cast<int>(in[v].size() + out[v].size()) + deleted[v];
+        };
+
+        typedef std::pair<int, size_t> order_t;
+        std::priority_queue<order_t, std::vector<order_t>, std::greater<order_t>> order{};
+        for (size_t v = 0; v < n; ++v)
+            order.push({priority(v), v});
+
+        _rank.assign(n, 0);
+        _up.assign(n, {});
+        _down.assign(n, {});
+
+        // contract nodes
+        size_t rank = 0;
+        while (!order.empty()) {
+
+            auto v = order.top().second;
+            order.pop();
+
+            // update priority (lazy)
+            auto p = priority(v);
+            if (!order.empty() && p > order.top().first) {
+                order.push({p, v});
+                continue;
+            }
+
+            // add shortcuts
+            _rank[v] = rank++;
+            shortcuts(v, true);
+
+            // move the remaining arcs to the hierarchy and remove the node from the working graph
+            for (const auto &b : out[v]) {
+                _up[v].push_back(b.second);
+                in[b.first].erase(v);
+                deleted[b.first]++;
+            }
+
+            for (const auto &a : in[v]) {
+                _down[v].push_back(a.second);
+                out[a.first].erase(v);
+                deleted[a.first]++;
+            }
+
+            out[v].clear();
+            in[v].clear();
+
+        }
+
+    }
+
+
+    bool ContractionHierarchy::load(const std::string &filename, const graph::Graph &laneNetwork) {
+
+        std::ifstream file(filename);
+        if (!file)
+            return false;
+
+        // collect nodes of the network
+        std::vector<std::map<size_t, double>> arcs{};
+        _collect(laneNetwork, arcs);
+
+        // check header
+        std::string header{};
+        size_t version = 0, n = 0;
+        uint64_t fingerprint = 0;
+
+        file >> header >> version >> n >> fingerprint;
+        if (!file || header != "simmap-ch" || version != 2 || n != _nodes.size() || fingerprint != _fingerprint) {
+            _nodes.clear();
+            _index.clear();
+            return false;
+        }
+
+        _rank.assign(n, 0);
+        _up.assign(n, {});
+        _down.assign(n, {});
+
+        // reads the arcs of a node
+        auto read = [&file, n](std::vector<Arc> &list) {
+
+            size_t count = 0;
+            file >> count;
+
+            list.resize(count);
+            for (auto &a : list) {
+
+                long long middle = 0;
+                file >> a.node >> a.weight >> middle;
+                a.middle = middle < 0 ? NONE : static_cast<size_t>(middle);
+
+                if (a.node >= n || (a.middle != NONE && a.middle >= n))
+                    return false;
+
+            }
+
+            return static_cast<bool>(file);
+
+        };
+
+        // read nodes (must match the nodes of the network)
+        for (size_t i = 0; i < n; ++i) {
+
+            // read ID (length-prefixed)
+            size_t length = 0;
+            file >> length;
+            file.get();
+
+            std::string id(length, ' ');
+            if (file && length != 0)
+                file.read(&id[0], static_cast<std::streamsize>(length));
+
+            int orientation = 0;
+            file >> orientation >> _rank[i];
+
+            if (!file || id != _nodes[i].second->id() || orientation != static_cast<int>(_nodes[i].first)
+                || !read(_up[i]) || !read(_down[i])) {
+                _nodes.clear();
+                _index.clear();
+                return false;
+            }
+
+        }
+
+        return true;
+
+    }
+
+
+    bool ContractionHierarchy::save(const std::string &filename) const {
+
+        // write to a temporary file first (concurrent writers and crashes never leave a truncated file)
+        std::ostringstream suffix{};
+        suffix << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id()) << std::random_device()();
+        auto temporary = filename + suffix.str();
+
+        if (!_write(temporary)) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+
+        // replace the file (the target is removed, if the file cannot be replaced on the platform)
+        if (std::rename(temporary.c_str(), filename.c_str()) == 0)
+            return true;
+
+        std::remove(filename.c_str());
+        if (std::rename(temporary.c_str(), filename.c_str()) == 0)
+            return true;
+
+        std::remove(temporary.c_str());
+        return false;
+
+    }
+
+
+    bool ContractionHierarchy::_write(const std::string &filename) const {
+
+        std::ofstream file(filename);
+        if (!file)
+            return false;
+
+        file << std::setprecision(17);
+        file << "simmap-ch 2\n" << _nodes.size() << " " << _fingerprint << "\n";
+
+        // writes the arcs of a node
+        auto write = [&file](const std::vector<Arc> &list) {
+
+            file << " " << list.size();
+            for (const auto &a : list)
+                file << " " << a.node << " " << a.weight << " "
+                     << (a.middle == NONE ? -1ll : static_cast<long long>(a.middle));
+
+        };
+
+        // write nodes
+        for (size_t i = 0; i < _nodes.size(); ++i) {
+
+            const auto &id = _nodes[i].second->id();
+            file << id.size() << " " << id << " " << static_cast<int>(_nodes[i].first) << " " << _rank[i];
+            write(_up[i]);
+            write(_down[i]);
+            file << "\n";
+
+        }
+
+        file.close();
+        return !file.fail();
+
+    }
+
+
+    bool ContractionHierarchy::empty() const {
+
+        return _nodes.empty();
+
+    }
+
+
+    bool ContractionHierarchy::route(const Track::TrackElement &start, const Track::TrackElement &target,
+                                     Track &track) const {
+
+        auto is = _index.find(start);
+        auto it = _index.find(target);
+        if (is == _index.end() || it == _index.end())
+            return false;
+
+        auto s = is->second;
+        auto t = it->second;
+
+        // upward search (parent of each node)
+        typedef std::unordered_map<size_t, std::pair<double, size_t>> labels_t;
+        auto search = [](const std::vector<std::vector<Arc>> &arcs, size_t source, labels_t &labels) {
+
+            labels[source] = {0.0, NONE};
+
+            queue_t queue{};
+            queue.push({0.0, source});
+
+            while (!queue.empty()) {
+
+                auto e = queue.top();
+                queue.pop();
+
+                if (e.first > labels.at(e.second).first)
+                    continue;
+
+                for (const auto &a : arcs[e.second]) {
+
+                    auto c = e.first + a.weight;
+                    auto l = labels.find(a.node);
+                    if (l == labels.end() || c < l->second.first) {
+                        labels[a.node] = {c, e.second};
+                        queue.push({c, a.node});
+                    }
+
+                }
+
+            }
+
+        };
+
+        labels_t forward{}, backward{};
+        search(_up, s, forward);
+        search(_down, t, backward);
+
+        // find meeting node
+        auto best = std::numeric_limits<double>::infinity();
+        auto meet = NONE;
+        for (const auto &f : forward) {
+
+            auto b = backward.find(f.first);
+            if (b != backward.end() && f.second.first + b->second.first < best) {
+                best = f.second.first + b->second.first;
+                meet = f.first;
+            }
+
+        }
+
+        if (meet == NONE)
+            return false;
+
+        // collect the nodes of the hierarchy (start to meeting node and meeting node to target)
+        std::vector<size_t> path{};
+        for (auto v = meet; v != NONE; v = forward.at(v).second)
+            path.push_back(v);
+
+        std::reverse(path.begin(), path.end());
+        for (auto v = backward.at(meet).second; v != NONE; v = backward.at(v).second)
+            path.push_back(v);
+
+        // unpack shortcuts
+        std::vector<size_t> nodes{s};
+        for (size_t i = 1; i < path.size(); ++i)
+            _unpack(path[i - 1], path[i], nodes);
+
+        track.clear();
+        for (auto v : nodes)
+            track.push_back(_nodes[v]);
+
+        return true;
+
+    }
+
+
+    size_t ContractionHierarchy::_middle(size_t u, size_t v) const {
+
+        // arc to a node of higher rank is stored at the source, otherwise at the target
+        const auto &list = _rank[u] < _rank[v] ? _up[u] : _down[v];
+        auto node = _rank[u] < _rank[v] ? v : u;
+
+        for (const auto &a : list) {
+            if (a.node == node)
+                return a.middle;
+        }
+
+        return NONE;
+
+    }
+
+
+    void ContractionHierarchy::_unpack(size_t u, size_t v, std::vector<size_t> &nodes) const {
+
+        auto m = _middle(u, v);
+        if (m == NONE) {
+            nodes.push_back(v);
+            return;
+        }
+
+        _unpack(u, m, nodes);
+        _unpack(m, v, nodes);
+
+    }
+
+}} // namespace ::simmap::server
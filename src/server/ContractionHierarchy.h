@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-19.
+//
+
+#ifndef SIMMAP_SERVER_CONTRACTIONHIERARCHY_H
+#define SIMMAP_SERVER_CONTRACTIONHIERARCHY_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <graph/Graph.h>
+#include "Track.h"
+
+#ifndef CONTRACTION_HIERARCHY_WITNESS_LIMIT
+#define CONTRACTION_HIERARCHY_WITNESS_LIMIT 100 // maximum number of settled nodes in a witness search
+#endif
+
+namespace simmap {
+namespace server {
+
+
+    /**
+     * @brief Contraction hierarchies on the road graph
+     * The nodes are the roads with driving direction (track elements), the arcs are derived from the successors of the
+     * lanes and are weighted with the length of the road. The nodes are contracted by the edge difference and
+     * shortcuts are added if no witness path exists. A query is a bidirectional search on the upward arcs, the
+     * shortcuts are unpacked into the roads of the route. The hierarchy can be saved to and loaded from a file, which is
+     * only accepted if the roads and a hash of the arcs match the network.
+     */
+    class ContractionHierarchy {
+
+    public:
+
+        /** Struct to define an arc of the hierarchy */
+        struct Arc {
+            size_t node;        /**< the other node of the arc */
+            double weight;      /**< the weight of the arc */
+            size_t middle;      /**< the contracted node of a shortcut (NONE for original arcs) */
+        };
+
+        static const size_t NONE;
+
+
+    private:
+
+        std::vector<Track::TrackElement> _nodes{};
+        std::map<Track::TrackElement, size_t> _index{};
+        std::vector<size_t> _rank{};
+        std::vector<std::vector<Arc>> _up{};    // arcs to nodes of higher rank
+        std::vector<std::vector<Arc>> _down{};  // arcs from nodes of higher rank (node is the source)
+
+        uint64_t _fingerprint = 0;             // hash of the original arcs
+
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        ContractionHierarchy() = default;
+
+
+        /**
+         * Builds the hierarchy for the roads of the given lane network
+         * @param laneNetwork Lane network
+         */
+        void build(const graph::Graph &laneNetwork);
+
+
+        /**
+         * Loads the hierarchy from the given file. The file is only accepted, if the road graph of the file matches
+         * the road graph of the given lane network
+         * @param filename File name
+         * @param laneNetwork Lane network
+         * @return Flag whether the hierarchy was loaded
+         */
+        bool load(const std::string &filename, const graph::Graph &laneNetwork);
+
+
+        /**
+         * Saves the hierarchy to the given file
+         * @param filename File name
+         * @return Flag whether the hierarchy was saved
+         */
+        bool save(const std::string &filename) const;
+
+
+        /**
+         * Checks whether the hierarchy is empty (not built or loaded)
+         * @return Flag whether the hierarchy is empty
+         */
+        bool empty() const;
+
+
+        /**
+         * Finds the shortest route between the two roads
+         * @param start Start road (with orientation)
+         * @param target Target road (with orientation)
+         * @param track Roads of the route (including the start and the target road)
+         * @return Flag whether a route was found
+         */
+        bool route(const Track::TrackElement &start, const Track::TrackElement &target, Track &track) const;
+
+
+    protected:
+
+        /**
+         * Collects the nodes and the original arcs from the given lane network
+         * @param laneNetwork Lane network
+         * @param arcs Original arcs (for each source node the target nodes and the weights)
+         */
+        void _collect(const graph::Graph &laneNetwork, std::vector<std::map<size_t, double>> &arcs);
+
+
+        /**
+         * Returns the contracted node of the arc between the two nodes
+         * @param u Source node
+         * @param v Target node
+         * @return Contracted node (NONE for original arcs)
+         */
+        size_t _middle(size_t u, size_t v) const;
+
+
+        /**
+         * Unpacks the arc between the two nodes and adds the nodes (without the source) to the given list
+         * @param u Source node
+         * @param v Target node
+         * @param nodes Nodes
+         */
+        void _unpack(size_t u, size_t v, std::vector<size_t> &nodes) const;
+
+
+        /**
+         * Writes the hierarchy to the given file
+         * @param filename File name
+         * @return Flag whether the hierarchy was written
+         */
+        bool _write(const std::string &filename) const;
+
+    };
+
+}} // namespace ::simmap::server
+
+#endif // SIMMAP_SERVER_CONTRACTIONHIERARCHY_H
@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-20.
+//
+
+
+#include "HorizonTree.h"
+#include "LaneEdge.h"
+#include <graph/Adjacency.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+namespace simmap {
+namespace server {
+
+
+    const size_t HorizonTree::NONE = std::numeric_limits<size_t>::max();
+
+
+    void HorizonTree::build(const LaneEdge *root, double length, size_t depth) {
+
+        _nodes.clear();
+
+        if (root == nullptr)
+            return;
+
+        // add root
+        _nodes.push_back(Node{root, NONE, 0, 0, 0.0, 1.0, 0});
+
+        // breadth-first expansion (the children of a node are added contiguously)
+        for (size_t i = 0; i < _nodes.size(); ++i) {
+
+            auto node = _nodes[i];
+            auto end = node.start + node.edge->length();
+
+            // check limits
+            if (node.depth >= depth || end >= length)
+                continue;
+
+            auto adjacency = node.edge->adjacency();
+            if (adjacency == nullptr)
+                throw std::runtime_error("lane is not indexed (see graph::Graph::index)");
+
+            // collect successors, which are not part of the branch, weighted by the change of the heading
+            std::vector<std::pair<const LaneEdge *, double>> next{};
+            auto psi = node.edge->position(node.edge->length()).angle;
+
+            double sum = 0.0;
+            for (const auto &l : adjacency->nexts(node.edge->handle())) {
+
+                auto e = static_cast<const LaneEdge *>(l.edge);
+                if (onBranch(i, e))
+                    continue;
+
+                auto w = 1.0 + std::cos(e->position(0.0).angle - psi);
+
+                next.emplace_back(e, w);
+                sum += w;
+
+            }
+
+            // most probable child first
+            std::stable_sort(next.begin(), next.end(), [](const std::pair<const LaneEdge *, double> &a,
+                                                          const std::pair<const LaneEdge *, double> &b) {
+                return a.second > b.second;
+            });
+
+            // add children
+            _nodes[i].first = _nodes.size();
+            _nodes[i].children = next.size();
+
+            for (const auto &n : next) {
+
+                auto p = sum > 0.0 ? n.second / sum : 1.0 / static_cast<double>(next.size());
+                _nodes.push_back(Node{n.first, i, 0, 0, end, node.probability * p, node.depth + 1});
+
+            }
+
+        }
+
+    }
+
+
+    bool HorizonTree::empty() const {
+
+        return _nodes.empty();
+
+    }
+
+
+    const std::vector<HorizonTree::Node> &HorizonTree::nodes() const {
+
+        return _nodes;
+
+    }
+
+
+    std::vector<size_t> HorizonTree::mostProbablePath() const {
+
+        std::vector<size_t> path{};
+        if (_nodes.empty())
+            return path;
+
+        // follow the first child
+        for (size_t i = 0; ; i = _nodes[i].first) {
+
+            path.push_back(i);
+            if (_nodes[i].children == 0)
+                break;
+
+        }
+
+        return path;
+
+    }
+
+
+    bool HorizonTree::onBranch(size_t node, const LaneEdge *edge) const {
+
+        for (auto i = node; i != NONE; i = _nodes[i].parent) {
+            if (_nodes[i].edge == edge)
+                return true;
+        }
+
+        return false;
+
+    }
+
+
+    std::shared_ptr<const HorizonTree> HorizonTreeCache::tree(const LaneEdge *root, double length, size_t depth) {
+
+        // round the length up
+        auto steps = static_cast<long>(std::ceil(std::max(0.0, length) / HORIZON_TREE_LENGTH_STEP));
+        auto key = std::make_tuple(root, steps, depth);
+
+        auto it = _trees.find(key);
+        if (it != _trees.end())
+            return it->second;
+
+        // limit the number of trees
+        if (_trees.size() >= HORIZON_TREE_CACHE_SIZE)
+            _trees.clear();
+
+        // build tree
+        auto tree = std::make_shared<HorizonTree>();
+        tree->build(root, static_cast<double>(steps) * HORIZON_TREE_LENGTH_STEP, depth);
+
+        _trees[key] = tree;
+        return tree;
+
+    }
+
+
+    size_t HorizonTreeCache::size() const {
+
+        return _trees.size();
+
+    }
+
+
+    void HorizonTreeCache::clear() {
+
+        _trees.clear();
+
+    }
+
+}} // namespace ::simmap::server
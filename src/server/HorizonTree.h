@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-20.
+//
+
+
+#ifndef SIMMAP_SERVER_HORIZONTREE_H
+#define SIMMAP_SERVER_HORIZONTREE_H
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#ifndef HORIZON_TREE_LENGTH_STEP
+#define HORIZON_TREE_LENGTH_STEP 100.0 // step of the lengths of the memoized horizon trees (in m)
+#endif
+
+#ifndef HORIZON_TREE_CACHE_SIZE
+#define HORIZON_TREE_CACHE_SIZE 1024 // maximum number of memoized horizon trees per map
+#endif
+
+namespace simmap {
+namespace server {
+
+    struct LaneEdge;
+
+
+    /**
+     * @brief Tree of the lanes reachable from a lane
+     * The nodes reference the lanes and their parent, so that the branches share the nodes of the common prefix. The
+     * nodes are stored in breadth-first order, the children of a node are stored contiguously and are sorted by the
+     * probability (most probable child first). The probability of a branch is split between the successors by the
+     * change of the heading. A lane is not added twice to a branch (loops end the branch).
+     */
+    class HorizonTree {
+
+    public:
+
+        /** Struct to define a node of the tree */
+        struct Node {
+            const LaneEdge *edge;       /**< the lane */
+            size_t parent;              /**< the index of the parent node (NONE for the root) */
+            size_t first;               /**< the index of the first child */
+            size_t children;            /**< the number of children */
+            double start;               /**< the distance from the start of the root lane to the start of the lane */
+            double probability;         /**< the probability to drive along the lane */
+            size_t depth;               /**< the number of lanes between the root and the lane */
+        };
+
+        static const size_t NONE;
+
+
+    private:
+
+        std::vector<Node> _nodes{};
+
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        HorizonTree() = default;
+
+
+        /**
+         * Builds the tree from the start of the given lane
+         * @param root Root lane
+         * @param length Maximum distance from the start of the root lane (lanes starting behind are not added)
+         * @param depth Maximum depth of the nodes
+         */
+        void build(const LaneEdge *root, double length, size_t depth);
+
+
+        /**
+         * Checks whether the tree is empty (not built)
+         * @return Flag whether the tree is empty
+         */
+        bool empty() const;
+
+
+        /**
+         * Returns the nodes of the tree (the first node is the root)
+         * @return Nodes
+         */
+        const std::vector<Node> &nodes() const;
+
+
+        /**
+         * Returns the most probable path (following the most probable child from the root to a leaf)
+         * @return Indices of the nodes
+         */
+        std::vector<size_t> mostProbablePath() const;
+
+
+        /**
+         * Checks whether the lane is part of the branch from the root to the given node
+         * @param node Index of the node
+         * @param edge Lane
+         * @return Flag whether the lane is part of the branch
+         */
+        bool onBranch(size_t node, const LaneEdge *edge) const;
+
+    };
+
+
+    /**
+     * @brief Memoized horizon trees of a map
+     * The trees are built on request and stored by the root lane, the length (rounded up to HORIZON_TREE_LENGTH_STEP)
+     * and the depth. The cache is cleared when the maximum number of trees is reached.
+     */
+    class HorizonTreeCache {
+
+        std::map<std::tuple<const LaneEdge *, long, size_t>, std::shared_ptr<const HorizonTree>> _trees{};
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        HorizonTreeCache() = default;
+
+
+        /**
+         * Returns the tree from the start of the given lane, which covers at least the given length
+         * @param root Root lane
+         * @param length Minimum distance from the start of the root lane
+         * @param depth Maximum depth of the nodes
+         * @return Tree
+         */
+        std::shared_ptr<const HorizonTree> tree(const LaneEdge *root, double length, size_t depth);
+
+
+        /**
+         * Returns the number of memoized trees
+         * @return Number of trees
+         */
+        size_t size() const;
+
+
+        /**
+         * Removes all trees
+         */
+        void clear();
+
+    };
+
+}} // namespace ::simmap::server
+
+#endif // SIMMAP_SERVER_HORIZONTREE_H
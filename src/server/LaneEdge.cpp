@@ -61,6 +61,39 @@ namespace server {
 
 
 
+    double LaneEdge::project(const base::Vector3 &xyz, double &d, double s) const {
+
+        auto len = length();
+        s = std::max(0.0, std::min(len, s));
+
+        base::CurvePoint p{};
+
+        // iterate to the foot point
+        for (int i = 0; i < 8; ++i) {
+
+            p = position(s);
+
+            auto ds = (xyz.x - p.position.x) * std::cos(p.angle) + (xyz.y - p.position.y) * std::sin(p.angle);
+            auto sn = std::max(0.0, std::min(len, s + ds));
+
+            auto done = std::abs(sn - s) < base::EPS_DISTANCE;
+            s = sn;
+
+            if (done)
+                break;
+
+        }
+
+        // calculate lateral offset
+        p = position(s);
+        d = -(xyz.x - p.position.x) * std::sin(p.angle) + (xyz.y - p.position.y) * std::cos(p.angle);
+
+        return s;
+
+    }
+
+
+
     Track::TrackElement LaneEdge::trackElement() const {
 
         return _trackElement;
@@ -125,6 +125,18 @@ struct LaneEdge : public ::graph::Edge {
 
 
 
+    /**
+     * Projects the given point on the lane center, i.e. calculates the position and the lateral offset of the foot
+     * point. The default implementation iterates along the lane, starting at the given position
+     * @param xyz Point to be projected (z is ignored)
+     * @param d Lateral offset to the lane center (will be updated, left is positive)
+     * @param s Position to start the search
+     * @return Position within the lane
+     */
+    virtual double project(const base::Vector3 &xyz, double &d, double s = 0.0) const;
+
+
+
     /**
      * Returns the track element
      * @return Track element
@@ -0,0 +1,338 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-09.
+//
+
+#include "LaneIndex.h"
+#include "LaneEdge.h"
+#include "LaneTessellation.h"
+#include <algorithm>
+#include <map>
+#include <base/functions.h>
+
+
+namespace simmap {
+namespace server {
+
+
+    /**
+     * Extends the box by the given point
+     * @param box Box
+     * @param x x coordinate
+     * @param y y coordinate
+     */
+    void extend(LaneIndex::Box &box, double x, double y) {
+
+        box.x0 = std::min(box.x0, x);
+        box.y0 = std::min(box.y0, y);
+        box.x1 = std::max(box.x1, x);
+        box.y1 = std::max(box.y1, y);
+
+    }
+
+
+    /**
+     * Sorts the elements in sort-tile-recursive order, i.e. in vertical slices sorted by y
+     * @tparam T Element type (with member box)
+     * @param elements Elements
+     */
+    template<typename T>
+    void strSort(std::vector<T> &elements) {
+
+        const size_t m = LANE_INDEX_NODE_SIZE;
+
+        auto cx = [](const T &e) { return e.box.x0 + e.box.x1; };
+        auto cy = [](const T &e) { return e.box.y0 + e.box.y1; };
+
+        // sort by x
+        std::sort(elements.begin(), elements.end(), [&cx](const T &a, const T &b) { return cx(a) < cx(b); });
+
+        // get slice size (multiple of the node size)
+        auto nodes = (elements.size() + m - 1) / m;
+        auto slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodes))));
+        auto size = std::max<size_t>(1, (nodes + slices - 1) / slices) * m;
+
+        // sort slices by y
+        for (size_t i = 0; i < elements.size(); i += size) {
+
+            auto end = std::next(elements.begin(), std::min(i + size, elements.size()));
+            std::sort(std::next(elements.begin(), i), end, [&cy](const T &a, const T &b) { return cy(a) < cy(b); });
+
+        }
+
+    }
+
+
+    void LaneIndex::build(const LaneTessellation &tessellation, double step) {
+
+        _entries.clear();
+        _nodes.clear();
+
+        // the polylines deviate from the lane borders by the chordal error
+        auto margin = tessellation.tolerance();
+
+        // split the polylines into strips
+        for (const auto &lane : tessellation.lanes()) {
+
+            const auto &s = lane.s;
+            if (s.size() < 2)
+                continue;
+
+            // adds the borders at the given position (interpolated on the current segment)
+            size_t j = 0;
+            auto add = [&lane, &s, &j](Box &box, double sv) {
+
+                while (j + 2 < s.size() && s[j + 1] < sv)
+                    ++j;
+
+                auto h = s[j + 1] - s[j];
+                auto t = h < base::EPS_DISTANCE ? 0.0 : std::max(0.0, std::min(1.0, (sv - s[j]) / h));
+
+                for (const auto *line : {&lane.left, &lane.right}) {
+                    const auto &p0 = (*line)[j];
+                    const auto &p1 = (*line)[j + 1];
+                    extend(box, p0.x + t * (p1.x - p0.x), p0.y + t * (p1.y - p0.y));
+                }
+
+            };
+
+            auto len = s.back();
+            auto n = static_cast<size_t>(std::ceil(len / step));
+            for (size_t i = 0; i < n; ++i) {
+
+                Entry entry{};
+                entry.edge = lane.edge;
+                entry.s0 = len * static_cast<double>(i) / static_cast<double>(n);
+                entry.s1 = len * static_cast<double>(i + 1) / static_cast<double>(n);
+
+                // add borders at the start, the vertices in between and the end of the strip
+                add(entry.box, entry.s0);
+
+                for (auto k = j + 1; k < s.size() && s[k] < entry.s1; ++k) {
+                    extend(entry.box, lane.left[k].x, lane.left[k].y);
+                    extend(entry.box, lane.right[k].x, lane.right[k].y);
+                }
+
+                add(entry.box, entry.s1);
+
+                // add margin for the chordal error
+                entry.box.x0 -= margin;
+                entry.box.y0 -= margin;
+                entry.box.x1 += margin;
+                entry.box.y1 += margin;
+
+                _entries.push_back(entry);
+
+            }
+
+        }
+
+        if (_entries.empty())
+            return;
+
+        // create leaves
+        strSort(_entries);
+
+        std::vector<Node> level{};
+        for (size_t i = 0; i < _entries.size(); i += LANE_INDEX_NODE_SIZE) {
+
+            Node node{};
+            node.begin = i;
+            node.end = std::min(i + LANE_INDEX_NODE_SIZE, _entries.size());
+
+            for (size_t j = node.begin; j < node.end; ++j) {
+                extend(node.box, _entries[j].box.x0, _entries[j].box.y0);
+                extend(node.box, _entries[j].box.x1, _entries[j].box.y1);
+            }
+
+            level.push_back(node);
+
+        }
+
+        // create levels up to the root
+        while (level.size() > 1) {
+
+            strSort(level);
+
+            // store level
+            auto offset = _nodes.size();
+            _nodes.insert(_nodes.end(), level.begin(), level.end());
+
+            // create parents
+            std::vector<Node> parents{};
+            for (size_t i = 0; i < level.size(); i += LANE_INDEX_NODE_SIZE) {
+
+                Node node{};
+                node.leaf = false;
+                node.begin = offset + i;
+                node.end = offset + std::min(i + LANE_INDEX_NODE_SIZE, level.size());
+
+                for (size_t j = i; j < node.end - offset; ++j) {
+                    extend(node.box, level[j].box.x0, level[j].box.y0);
+                    extend(node.box, level[j].box.x1, level[j].box.y1);
+                }
+
+                parents.push_back(node);
+
+            }
+
+            level = std::move(parents);
+
+        }
+
+        // the root is the last node
+        _nodes.push_back(level.front());
+
+    }
+
+
+    size_t LaneIndex::size() const {
+
+        return _entries.size();
+
+    }
+
+
+    void LaneIndex::query(double x, double y, double radius, std::vector<const Entry *> &entries) const {
+
+        if (_nodes.empty())
+            return;
+
+        auto hit = [x, y, radius](const Box &b) {
+            return x >= b.x0 - radius && x <= b.x1 + radius && y >= b.y0 - radius && y <= b.y1 + radius;
+        };
+
+        // traverse tree
+        std::vector<size_t> stack{_nodes.size() - 1};
+        while (!stack.empty()) {
+
+            const auto &node = _nodes[stack.back()];
+            stack.pop_back();
+
+            if (!hit(node.box))
+                continue;
+
+            for (size_t i = node.begin; i < node.end; ++i) {
+
+                if (!node.leaf)
+                    stack.push_back(i);
+                else if (hit(_entries[i].box))
+                    entries.push_back(&_entries[i]);
+
+            }
+
+        }
+
+    }
+
+
+    bool LaneIndex::project(const Entry &entry, double x, double y, double heading, double tolerance,
+                            Candidate &candidate) const {
+
+        auto edge = entry.edge;
+
+        // project point on the lane
+        double d = 0.0;
+        auto s = edge->project(base::Vector3{x, y, 0.0}, d, 0.5 * (entry.s0 + entry.s1));
+
+        // get longitudinal distance (beyond the ends of the lane)
+        auto p = edge->position(s);
+        auto u = std::abs((x - p.position.x) * std::cos(p.angle) + (y - p.position.y) * std::sin(p.angle));
+
+        // check lateral distance
+        auto outside = std::abs(d) - 0.5 * edge->width(s);
+        if (outside > tolerance || u > tolerance + base::EPS_DISTANCE)
+            return false;
+
+        // check heading
+        auto dPsi = std::isnan(heading) ? 0.0 : base::angleDiff(heading, p.angle);
+        if (std::abs(dPsi) > 0.5 * M_PI)
+            return false;
+
+        candidate = Candidate{edge, s, d, dPsi, outside + u + LANE_INDEX_HEADING_WEIGHT * std::abs(dPsi)};
+        return true;
+
+    }
+
+
+    std::vector<LaneIndex::Candidate> LaneIndex::locate(double x, double y, double heading, double tolerance) const {
+
+        // get strips
+        std::vector<const Entry *> entries{};
+        query(x, y, tolerance, entries);
+
+        // project point on the lanes (best candidate per lane)
+        std::map<const LaneEdge *, Candidate> best{};
+        for (auto e : entries) {
+
+            Candidate c{};
+            if (!project(*e, x, y, heading, tolerance, c))
+                continue;
+
+            // save candidate
+            auto it = best.find(e->edge);
+            if (it == best.end() || std::abs(c.d) < std::abs(it->second.d))
+                best[e->edge] = c;
+
+        }
+
+        // sort by lateral distance
+        std::vector<Candidate> candidates{};
+        candidates.reserve(best.size());
+        for (const auto &c : best)
+            candidates.push_back(c.second);
+
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            return std::abs(a.d) < std::abs(b.d);
+        });
+
+        return candidates;
+
+    }
+
+
+    bool LaneIndex::match(double x, double y, double heading, Candidate &candidate, double radius) const {
+
+        // get strips
+        std::vector<const Entry *> entries{};
+        query(x, y, radius, entries);
+
+        // find candidate with the lowest score
+        bool found = false;
+        for (auto e : entries) {
+
+            Candidate c{};
+            if (!project(*e, x, y, heading, radius, c))
+                continue;
+
+            if (!found || c.score < candidate.score)
+                candidate = c;
+
+            found = true;
+
+        }
+
+        return found;
+
+    }
+
+}} // namespace ::simmap::server
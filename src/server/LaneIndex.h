@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-09.
+//
+
+#ifndef SIMMAP_SERVER_LANEINDEX_H
+#define SIMMAP_SERVER_LANEINDEX_H
+
+#include <cmath>
+#include <vector>
+#include <graph/Graph.h>
+#include "LaneTessellation.h"
+
+#ifndef LANE_INDEX_STEP
+#define LANE_INDEX_STEP 5.0 // maximum length of the indexed lane strips
+#endif
+
+#ifndef LANE_INDEX_NODE_SIZE
+#define LANE_INDEX_NODE_SIZE 16 // maximum number of children of a tree node
+#endif
+
+#ifndef LANE_INDEX_MATCH_RADIUS
+#define LANE_INDEX_MATCH_RADIUS 5.0 // maximum distance of a matched position to the lane border
+#endif
+
+#ifndef LANE_INDEX_HEADING_WEIGHT
+#define LANE_INDEX_HEADING_WEIGHT 5.0 // weight of the heading difference in the matching score (in m/rad)
+#endif
+
+namespace simmap {
+namespace server {
+
+    struct LaneEdge;
+
+
+    /**
+     * @brief Spatial index over the lanes of a map
+     * The tessellated lanes are split into strips, the bounding boxes of the strips (enclosing the polylines of the
+     * borders, extended by the chordal error) are stored in an R-tree, which is bulk loaded (sort-tile-recursive) once
+     * after the map is loaded. The index is not changed afterwards, so it can be
+     * queried from several threads.
+     */
+    class LaneIndex {
+
+    public:
+
+        /** Struct to define an axis-aligned bounding box */
+        struct Box {
+            double x0 = INFINITY;  /**< the minimum x coordinate */
+            double y0 = INFINITY;  /**< the minimum y coordinate */
+            double x1 = -INFINITY; /**< the maximum x coordinate */
+            double y1 = -INFINITY; /**< the maximum y coordinate */
+        };
+
+
+        /** Struct to define a strip of a lane */
+        struct Entry {
+            Box box{};                       /**< the bounding box of the strip */
+            const LaneEdge *edge = nullptr;  /**< the lane */
+            double s0 = 0.0;                 /**< the start position of the strip on the lane */
+            double s1 = 0.0;                 /**< the end position of the strip on the lane */
+        };
+
+
+        /** Struct to define a lane containing a located position */
+        struct Candidate {
+            const LaneEdge *edge = nullptr;  /**< the lane */
+            double s = 0.0;                  /**< the longitudinal position on the lane */
+            double d = 0.0;                  /**< the lateral distance to the lane center (left is positive) */
+            double dPsi = 0.0;               /**< the angle between the given heading and the lane direction */
+            double score = 0.0;              /**< the matching score (lower is better) */
+        };
+
+
+    private:
+
+        /** Struct to define a node of the tree */
+        struct Node {
+            Box box{};                       /**< the bounding box of all children */
+            size_t begin = 0;                /**< the index of the first child (entry or node) */
+            size_t end = 0;                  /**< the index after the last child (entry or node) */
+            bool leaf = true;                /**< flag whether the children are entries */
+        };
+
+        std::vector<Entry> _entries{};
+        std::vector<Node> _nodes{};
+
+
+        /**
+         * Projects the point on the lane of the given strip and scores the result
+         * @param entry Strip
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param heading Heading (NAN to ignore the heading)
+         * @param tolerance Lateral tolerance beyond the lane borders
+         * @param candidate Candidate to be filled
+         * @return Flag whether the point is on the lane (within the tolerance) and the lane fits the heading
+         */
+        bool project(const Entry &entry, double x, double y, double heading, double tolerance,
+                     Candidate &candidate) const;
+
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        LaneIndex() = default;
+
+
+        /**
+         * Builds the index from the polylines of the given tessellation
+         * @param tessellation Tessellated lanes
+         * @param step Maximum length of the strips
+         */
+        void build(const LaneTessellation &tessellation, double step = LANE_INDEX_STEP);
+
+
+        /**
+         * Returns the number of indexed strips
+         * @return Number of strips
+         */
+        size_t size() const;
+
+
+        /**
+         * Finds all strips whose bounding box is closer than the given radius to the given point
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param radius Radius
+         * @param entries Vector to be filled with the strips
+         */
+        void query(double x, double y, double radius, std::vector<const Entry *> &entries) const;
+
+
+        /**
+         * Finds the lanes containing the given point, sorted by the lateral distance to the lane center. If a heading
+         * is given, lanes with an angle of more than 90 deg to the heading are ignored
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param heading Heading (NAN to ignore the heading)
+         * @param tolerance Lateral tolerance beyond the lane borders
+         * @return Candidates
+         */
+        std::vector<Candidate> locate(double x, double y, double heading = NAN, double tolerance = 0.0) const;
+
+
+        /**
+         * Matches the given point to the best fitting lane. The candidates are scored by the lateral distance to the
+         * lane border (negative inside the lane) and the weighted angle between the heading and the lane direction
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param heading Heading (NAN to ignore the heading)
+         * @param candidate Best candidate
+         * @param radius Maximum distance to the lane border
+         * @return Flag whether a lane was found
+         */
+        bool match(double x, double y, double heading, Candidate &candidate,
+                   double radius = LANE_INDEX_MATCH_RADIUS) const;
+
+    };
+
+}} // namespace ::simmap::server
+
+#endif // SIMMAP_SERVER_LANEINDEX_H
@@ -0,0 +1,250 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-16.
+//
+
+#include "LaneTessellation.h"
+#include "LaneEdge.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+
+namespace simmap {
+namespace server {
+
+
+    /**
+     * Returns the distance of the point to the chord between the two given points
+     * @param p Point
+     * @param p0 Start of the chord
+     * @param p1 End of the chord
+     * @return Distance
+     */
+    double chordDistance(const base::Vector3 &p, const base::Vector3 &p0, const base::Vector3 &p1) {
+
+        auto dx = p1.x - p0.x;
+        auto dy = p1.y - p0.y;
+        auto len = std::sqrt(dx * dx + dy * dy);
+
+        if (len < base::EPS_DISTANCE)
+            return std::sqrt((p.x - p0.x) * (p.x - p0.x) + (p.y - p0.y) * (p.y - p0.y));
+
+        return std::abs((p.x - p0.x) * dy - (p.y - p0.y) * dx) / len;
+
+    }
+
+
+    void LaneTessellation::build(const graph::Graph &laneNetwork, double tolerance, unsigned int threads) {
+
+        _lanes.clear();
+        _index.clear();
+        _tolerance = tolerance;
+
+        // collect lanes (ignore lanes without width, e.g. center lanes)
+        for (const auto &e : laneNetwork) {
+
+            auto edge = dynamic_cast<const LaneEdge *>(e.second.get());
+            if (edge == nullptr || edge->length() < base::EPS_DISTANCE)
+                continue;
+
+            auto len = edge->length();
+            if (edge->width(0.0) < base::EPS_DISTANCE && edge->width(0.5 * len) < base::EPS_DISTANCE
+                && edge->width(len) < base::EPS_DISTANCE)
+                continue;
+
+            _index[edge] = _lanes.size();
+            _lanes.emplace_back();
+            _lanes.back().edge = edge;
+
+        }
+
+        // get number of threads
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+
+        threads = std::min<unsigned int>(threads, static_cast<unsigned int>(_lanes.size()));
+
+        // tessellate lanes (each thread takes every n-th lane)
+        auto work = [this, tolerance, threads](unsigned int k) {
+            for (size_t i = k; i < _lanes.size(); i += threads)
+                tessellate(_lanes[i].edge, tolerance, _lanes[i]);
+        };
+
+        std::vector<std::thread> pool{};
+        for (unsigned int k = 1; k < threads; ++k)
+            pool.emplace_back(work, k);
+
+        if (threads > 0)
+            work(0);
+
+        for (auto &t : pool)
+            t.join();
+
+    }
+
+
+    void LaneTessellation::tessellate(const LaneEdge *edge, double tolerance, Lane &lane) {
+
+        const base::Reference refs[3] = {base::Reference::INNER, base::Reference::CENTER, base::Reference::OUTER};
+
+        lane.edge = edge;
+        lane.s.clear();
+        lane.left.clear();
+        lane.center.clear();
+        lane.right.clear();
+
+        auto len = edge->length();
+        std::vector<base::Vector3> *lines[3] = {&lane.left, &lane.center, &lane.right};
+
+        // adds a vertex and returns the maximum curvature of the borders
+        auto add = [&lane, &lines, edge, &refs](double s) {
+
+            double kappa = 0.0;
+
+            lane.s.push_back(s);
+            for (size_t i = 0; i < 3; ++i) {
+
+                auto p = edge->position(s, refs[i], 0.0);
+                lines[i]->push_back(p.position);
+                kappa = std::max(kappa, std::abs(p.curvature));
+
+            }
+
+            return kappa;
+
+        };
+
+        // returns the maximum chordal error of the borders between the last vertex and the given position
+        auto error = [&lane, &lines, edge, &refs](double s) {
+
+            auto sm = 0.5 * (lane.s.back() + s);
+
+            double err = 0.0;
+            for (size_t i = 0; i < 3; ++i) {
+
+                auto p1 = edge->position(s, refs[i], 0.0).position;
+                auto pm = edge->position(sm, refs[i], 0.0).position;
+
+                err = std::max(err, chordDistance(pm, lines[i]->back(), p1));
+
+            }
+
+            return err;
+
+        };
+
+        // walk along the lane
+        double s = 0.0;
+        double kappa = add(s);
+
+        while (s < len) {
+
+            // estimate second derivative of the width (the outer border is bent by the full value)
+            auto ds = std::min(1.0, 0.5 * len);
+            auto s0 = std::max(0.0, std::min(len - 2.0 * ds, s - ds));
+            auto wDot2 = std::abs(edge->width(s0) - 2.0 * edge->width(s0 + ds) + edge->width(s0 + 2.0 * ds)) / (ds * ds);
+
+            // estimate step from the chordal error of an arc (e = h^2 * kappa / 8, with a margin of 10 %)
+            auto bend = kappa + wDot2;
+            auto h = bend < base::EPS_CURVATURE ? LANE_TESSELLATION_MAX_STEP : 0.9 * std::sqrt(8.0 * tolerance / bend);
+            h = std::max(LANE_TESSELLATION_MIN_STEP, std::min(LANE_TESSELLATION_MAX_STEP, h));
+
+            // limit to the end of the lane (avoid a tiny last step)
+            h = std::min(h, len - s);
+            if (len - s - h < LANE_TESSELLATION_MIN_STEP)
+                h = len - s;
+
+            // reduce step until the error is below the tolerance
+            while (h > LANE_TESSELLATION_MIN_STEP && error(s + h) > tolerance)
+                h = std::max(LANE_TESSELLATION_MIN_STEP, 0.5 * h);
+
+            s = len - s - h < base::EPS_DISTANCE ? len : s + h;
+            kappa = add(s);
+
+        }
+
+    }
+
+
+    size_t LaneTessellation::size() const {
+
+        return _lanes.size();
+
+    }
+
+
+    const LaneTessellation::Lane *LaneTessellation::lane(const LaneEdge *edge) const {
+
+        auto it = _index.find(edge);
+        return it == _index.end() ? nullptr : &_lanes[it->second];
+
+    }
+
+
+    const std::vector<LaneTessellation::Lane> &LaneTessellation::lanes() const {
+
+        return _lanes;
+
+    }
+
+
+    double LaneTessellation::tolerance() const {
+
+        return _tolerance;
+
+    }
+
+
+    bool LaneTessellation::inside(const LaneEdge *edge, double x, double y) const {
+
+        auto l = lane(edge);
+        if (l == nullptr)
+            return false;
+
+        // create polygon (left border forwards, right border backwards)
+        std::vector<const base::Vector3 *> polygon{};
+        polygon.reserve(2 * l->s.size());
+
+        for (const auto &v : l->left)
+            polygon.push_back(&v);
+
+        for (auto it = l->right.rbegin(); it != l->right.rend(); ++it)
+            polygon.push_back(&*it);
+
+        // ray casting
+        bool in = false;
+        for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+
+            const auto &a = *polygon[i];
+            const auto &b = *polygon[j];
+
+            if ((a.y > y) != (b.y > y) && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x)
+                in = !in;
+
+        }
+
+        return in;
+
+    }
+
+}} // namespace ::simmap::server
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-16.
+//
+
+#ifndef SIMMAP_SERVER_LANETESSELLATION_H
+#define SIMMAP_SERVER_LANETESSELLATION_H
+
+#include <map>
+#include <vector>
+#include <graph/Graph.h>
+#include <base/definitions.h>
+
+#ifndef LANE_TESSELLATION_TOLERANCE
+#define LANE_TESSELLATION_TOLERANCE 0.02 // maximum chordal error of the tessellated lane boundaries
+#endif
+
+#ifndef LANE_TESSELLATION_MIN_STEP
+#define LANE_TESSELLATION_MIN_STEP 0.1 // minimum distance between two vertices of a tessellated lane
+#endif
+
+#ifndef LANE_TESSELLATION_MAX_STEP
+#define LANE_TESSELLATION_MAX_STEP 50.0 // maximum distance between two vertices of a tessellated lane
+#endif
+
+namespace simmap {
+namespace server {
+
+    struct LaneEdge;
+
+
+    /**
+     * @brief Polylines of the lane boundaries
+     * The lanes are tessellated into polylines of the left border (inner), the center and the right border (outer),
+     * which share the positions of the vertices. The step size is estimated from the curvature and the change of the
+     * width and is reduced until the chordal error of all three polylines is below the tolerance. The tessellation is
+     * created in parallel once after the map is loaded and is not changed afterwards.
+     */
+    class LaneTessellation {
+
+    public:
+
+        /** Struct to define the polylines of a lane */
+        struct Lane {
+            const LaneEdge *edge = nullptr;       /**< the lane */
+            std::vector<double> s{};              /**< the positions of the vertices on the lane */
+            std::vector<base::Vector3> left{};    /**< the vertices of the left border (inner) */
+            std::vector<base::Vector3> center{};  /**< the vertices of the lane center */
+            std::vector<base::Vector3> right{};   /**< the vertices of the right border (outer) */
+        };
+
+
+    private:
+
+        std::vector<Lane> _lanes{};
+        std::map<const LaneEdge *, size_t> _index{};
+
+        double _tolerance = LANE_TESSELLATION_TOLERANCE;
+
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        LaneTessellation() = default;
+
+
+        /**
+         * Tessellates the lanes of the given network (lanes without width are ignored)
+         * @param laneNetwork Lane network
+         * @param tolerance Maximum chordal error
+         * @param threads Number of threads (0 = number of hardware threads)
+         */
+        void build(const graph::Graph &laneNetwork, double tolerance = LANE_TESSELLATION_TOLERANCE,
+                   unsigned int threads = 0);
+
+
+        /**
+         * Tessellates the given lane
+         * @param edge Lane
+         * @param tolerance Maximum chordal error
+         * @param lane Polylines to be filled
+         */
+        static void tessellate(const LaneEdge *edge, double tolerance, Lane &lane);
+
+
+        /**
+         * Returns the number of tessellated lanes
+         * @return Number of lanes
+         */
+        size_t size() const;
+
+
+        /**
+         * Returns the polylines of the given lane
+         * @param edge Lane
+         * @return Polylines (nullptr if the lane is not tessellated)
+         */
+        const Lane *lane(const LaneEdge *edge) const;
+
+
+        /**
+         * Returns the polylines of all lanes
+         * @return Polylines
+         */
+        const std::vector<Lane> &lanes() const;
+
+
+        /**
+         * Returns the maximum chordal error of the polylines
+         * @return Tolerance
+         */
+        double tolerance() const;
+
+
+        /**
+         * Checks whether the given point is inside the polygon of the given lane (left border and reversed right
+         * border)
+         * @param edge Lane
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return Flag whether the point is inside the lane
+         */
+        bool inside(const LaneEdge *edge, double x, double y) const;
+
+    };
+
+}} // namespace ::simmap::server
+
+#endif // SIMMAP_SERVER_LANETESSELLATION_H
@@ -26,7 +26,12 @@
 #define SIMMAP_SERVER_MAP_H
 
 #include <graph/Graph.h>
+#include "ContractionHierarchy.h"
+#include "HorizonTree.h"
 #include "LaneEdge.h"
+#include "LaneIndex.h"
+#include "LaneTessellation.h"
+#include "Route.h"
 #include "Track.h"
 
 namespace simmap {
@@ -41,11 +46,38 @@ namespace server {
 
         graph::Graph _roadNetwork{};
         graph::Graph _laneNetwork{};
+        LaneIndex _laneIndex{};
+        LaneTessellation _laneTessellation{};
+        ContractionHierarchy _hierarchy{};
+        HorizonTreeCache _horizonTrees{}; // memoized horizon trees of the lanes
+        RouteCache _routes{};             // compiled routes shared by the agents
+
+        std::vector<const LaneEdge *> _lanes{}; // lanes by handle
 
         Map() = default;
         virtual ~Map() = default;
 
 
+        /**
+         * Creates the handles of the lanes and the roads (to be called after the networks are created)
+         */
+        void index() {
+
+            _laneNetwork.index();
+            _roadNetwork.index();
+
+            // trees of the previous lanes are not valid anymore
+            _horizonTrees.clear();
+
+            // cast lanes once
+            _lanes.clear();
+            _lanes.reserve(_laneNetwork._edges.size());
+            for (auto e : _laneNetwork._edges)
+                _lanes.push_back(dynamic_cast<const LaneEdge *>(e));
+
+        }
+
+
         /**
          * Returns the desired edge as LaneEdge
          * @param name Name of the edge
@@ -53,7 +85,24 @@ namespace server {
          */
         const LaneEdge *getEdge(const std::string &name) {
 
-            return dynamic_cast<LaneEdge*>(_laneNetwork.at(name).get());
+            // use interned IDs (fall back to the network, which throws if the edge does not exist)
+            auto handle = _laneNetwork.handle(name);
+            if (handle == graph::Graph::NONE)
+                return dynamic_cast<LaneEdge*>(_laneNetwork.at(name).get());
+
+            return _lanes[handle];
+
+        }
+
+
+        /**
+         * Returns the desired edge as LaneEdge
+         * @param handle Handle of the edge
+         * @return Edge (nullptr if the handle is not valid)
+         */
+        const LaneEdge *getEdge(size_t handle) const {
+
+            return handle < _lanes.size() ? _lanes[handle] : nullptr;
 
         }
 
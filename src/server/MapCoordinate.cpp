@@ -24,6 +24,7 @@
 
 #include "MapCoordinate.h"
 #include "LaneEdge.h"
+#include <graph/Adjacency.h>
 
 
 namespace simmap {
@@ -110,9 +111,16 @@ namespace server {
 
     MapCoordinate MapCoordinate::neighbor(size_t n, bool toRight) const {
 
-        // get neighbored edge
-        auto e = edge()->neighbor(s(), toRight ? ::graph::Neighbored::Side::RIGHT : ::graph::Neighbored::Side::LEFT, n);
-        auto *edge = dynamic_cast<const LaneEdge*>(e.second);
+        auto side = toRight ? ::graph::Neighbored::Side::RIGHT : ::graph::Neighbored::Side::LEFT;
+
+        // get neighbored edge (from the strips of the lane network, if indexed)
+        std::pair<double, const ::graph::Neighbored *> e{};
+        if (edge()->adjacency() != nullptr)
+            e = edge()->adjacency()->neighbor(edge()->handle(), s(), side, n);
+        else
+            e = edge()->neighbor(s(), side, n);
+
+        auto *edge = static_cast<const LaneEdge*>(e.second);
 
         // return out of road map coordinate
         if(e.second == nullptr)
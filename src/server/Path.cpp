@@ -23,6 +23,7 @@
 //
 
 #include "Path.h"
+#include "HorizonTree.h"
 #include "MapCoordinate.h"
 #include "Track.h"
 
@@ -37,28 +38,37 @@ namespace simmap {
 namespace server {
 
 
-base::CurvePoint Path::Matcher::operator()(double s, double &d) const
-{
-    // calculate position
-    auto pos = path->positionAt(s).absolutePosition();
+/**
+ * Returns the successors or the predecessors of the edge from the frozen adjacency of the lane network
+ * @param edge Edge
+ * @param forward Flag to get the successors (true) or the predecessors (false)
+ * @return Links
+ */
+::graph::Adjacency::Range<::graph::Adjacency::Link> links(const ::graph::Edge *edge, bool forward) {
 
-    // calculate result
-    base::Vector3 diff = pos.position - *xyz;
-    d = diff.x * diff.x + diff.y * diff.y + diff.z * diff.z;
+    auto adjacency = edge->adjacency();
+    if (adjacency == nullptr)
+        throw std::runtime_error("edge is not indexed (see graph::Graph::index)");
 
-    return pos;
+    return forward ? adjacency->nexts(edge->handle()) : adjacency->prevs(edge->handle());
 
 }
 
-base::Vector3 Path::Matcher::bounds() const {
 
-    return {-path->distanceToBack(), path->distanceToHead(), 0.0};
+void Path::create(Path &path, Track &track, double lenHead, double lenBack, const MapCoordinate &position) {
 
-}
+    // rotate track to the position
+    updateTrack(position, track);
+
+    // create path along the compiled track
+    size_t index = 0;
+    create(path, Route(track), index, lenHead, lenBack, position);
 
+}
 
 
-void Path::create(Path &path, Track &track, double lenHead, double lenBack, const MapCoordinate &position) {
+void Path::create(Path &path, const Route &route, size_t &index, double lenHead, double lenBack,
+                  const MapCoordinate &position) {
 
     if (lenBack < 0.0 || lenHead < 0.0)
         throw std::invalid_argument("Lengths must be larger than zero");
@@ -75,7 +85,7 @@ void Path::create(Path &path, Track &track, double lenHead, double lenBack, cons
     path._backPos  = position.s();
 
     // update path
-    path.updatePath(lenHead, lenBack, track);
+    path.updatePath(lenHead, lenBack, route, index);
 
 }
 
@@ -83,23 +93,37 @@ void Path::create(Path &path, Track &track, double lenHead, double lenBack, cons
 
 void Path::updatePath(double lenHead, double lenBack, Track &track) {
 
+    // update track
+    updateTrack(position(), track);
+
+    // update path along the compiled track
+    size_t index = 0;
+    updatePath(lenHead, lenBack, Route(track), index);
+
+}
+
+
+void Path::updatePath(double lenHead, double lenBack, const Route &route, size_t &index) {
+
     if (lenHead < 0.0 && lenBack < 0.0)
         throw std::invalid_argument("length must not be negative");
 
-    // update track
-    updateTrack(position(), track);
+    // update index (kept, if the road is not part of the route)
+    auto i = route.find(position().edge()->trackElement(), index);
+    if (i != route.size())
+        index = i;
 
     // reset segments list
     _segments = {*(_it)};
     _it = _segments.begin();
 
     // extend path in forward direction
-    size_t tin = 0;
-    extendPath(lenHead, track, tin);
+    size_t tin = index;
+    extendPath(lenHead, route, tin);
 
     // extend path in backward direction
-    tin = 0;
-    extendPath(-lenBack, track, tin);
+    tin = index;
+    extendPath(-lenBack, route, tin);
 
 }
 
@@ -107,14 +131,14 @@ void Path::updatePath(double lenHead, double lenBack, Track &track) {
 
 MapCoordinate Path::position() const {
 
-    return MapCoordinate{dynamic_cast<const LaneEdge*>(*_it), _s, _d};
+    return MapCoordinate{*_it, _s, _d};
 
 }
 
 
 void Path::position(double s, double d) {
 
-    ::graph::Path::position(s);
+    TypedPath::position(s);
     _d = d;
 
 }
@@ -123,14 +147,14 @@ void Path::position(double s, double d) {
 
 MapCoordinate Path::head() const {
 
-    return MapCoordinate(dynamic_cast<const LaneEdge*>(*_head().it), _head().s, 0.0);
+    return MapCoordinate(*_head().it, _head().s, 0.0);
 
 }
 
 
 MapCoordinate Path::back() const {
 
-    return MapCoordinate(dynamic_cast<const LaneEdge*>(*_back().it), _back().s, 0.0);
+    return MapCoordinate(*_back().it, _back().s, 0.0);
 
 }
 
@@ -138,7 +162,7 @@ MapCoordinate Path::back() const {
 MapCoordinate Path::positionAt(double s, double d) const {
 
     auto r = index(s);
-    return MapCoordinate(dynamic_cast<const LaneEdge*>(*r.it), r.s, d);
+    return MapCoordinate(*r.it, r.s, d);
 
 }
 
@@ -154,7 +178,7 @@ Track Path::track() const {
     for(const auto &edge : _segments) {
 
         // get road and direction of lane
-        const auto trElem = dynamic_cast<const LaneEdge*>(edge)->trackElement();
+        const auto trElem = edge->trackElement();
 
         // add track element
         if(ro != trElem)
@@ -176,7 +200,7 @@ bool Path::hasRoad(const Track::TrackElement &road) const {
     for(const auto &edge : _segments) {
 
         // check if road and orientation fit
-        if(dynamic_cast<const LaneEdge*>(edge)->trackElement() == road)
+        if(edge->trackElement() == road)
             return true;
 
     }
@@ -229,7 +253,7 @@ size_t Path::findTrackElement(const MapCoordinate &coordinate, const Track &trac
 }
 
 
-void Path::extendPath(double ds, const Track &track, size_t &trackIndex) {
+void Path::extendPath(double ds, const Route &route, size_t &routeIndex) {
 
     if(ds == 0.0)
         return;
@@ -238,7 +262,7 @@ void Path::extendPath(double ds, const Track &track, size_t &trackIndex) {
     auto forward = ds > 0.0;
 
     // initialize variables
-    const ::graph::Oriented::Connections* con;
+    ::graph::Adjacency::Range<::graph::Adjacency::Link> con{};
     size_t tin;
 
     // remove current edge length
@@ -251,28 +275,34 @@ void Path::extendPath(double ds, const Track &track, size_t &trackIndex) {
     // do until ds length is reached
     while((forward && ds > 0.0) || (!forward && ds < 0.0)) {
 
+        // abort if no route is set
+        if (route.empty()) {
+            ds = 0.0;
+            break;
+        }
+
         // get successors or predecessors
         if (forward) {
 
-            con = &_segments.back()->nexts();
-            tin = (trackIndex + 1) % track.size();
+            con = links(_segments.back(), true);
+            tin = route.next(routeIndex);
 
         } else {
 
-            con = &_segments.front()->prevs();
-            tin = (trackIndex - 1 + track.size()) % track.size();
+            con = links(_segments.front(), false);
+            tin = route.previous(routeIndex);
 
         }
 
-        // get track iterators
-        auto itc = std::next(track.begin(), trackIndex);
-        auto itn = std::next(track.begin(), tin);
+        // get current and next road
+        auto itc = &route[routeIndex].element;
+        auto itn = &route[tin].element;
 
         // check which connection fits
         auto add = false;
-        for (const auto &c : *con) {
+        for (const auto &c : con) {
 
-            auto edge = dynamic_cast<LaneEdge *>(c.second);
+            auto edge = static_cast<const LaneEdge *>(c.edge);
 
             // check if same road
             // TODO: better way with operator==?
@@ -285,7 +315,7 @@ void Path::extendPath(double ds, const Track &track, size_t &trackIndex) {
                 || (edge->isForward() == (itn->first == base::Orientation::FORWARDS)))) {
 
                 add = true;
-                trackIndex = tin;
+                routeIndex = tin;
 
             }
 
@@ -331,59 +361,97 @@ void Path::extendPath(double ds, const Track &track, size_t &trackIndex) {
 void Path::createRecursively(std::list<Path*> &paths, const LaneEdge *edge, double len) {
 
     // path and tracks
-    auto p = new Path;
+    Path root{};
     auto tr = Track{};
 
     // create path
-    create(*p, tr, 0.0, 0.0, {edge, 0.0, 0.0});
+    create(root, tr, 0.0, 0.0, {edge, 0.0, 0.0});
 
-    // add path to vector
-    paths.push_back(p);
+    // create the tree of the successors (the branches share their prefix, loops end a branch)
+    HorizonTree tree{};
+    tree.build(edge, len + edge->length(), HorizonTree::NONE);
 
-    // recursion
-    extendRecursively(paths, len);
+    // add a path for each leaf
+    const auto &nodes = tree.nodes();
+    for (size_t i = 0; i < nodes.size(); ++i) {
 
-}
+        if (nodes[i].children != 0)
+            continue;
 
+        // add the edges of the branch behind the start edge
+        auto p = new Path(root);
+        for (auto j = i; nodes[j].parent != HorizonTree::NONE; j = nodes[j].parent)
+            p->_segments.insert(std::next(p->_segments.begin()), nodes[j].edge);
 
-double Path::match(const base::Vector3 &xyz, double &s, double radius) const {
+        paths.push_back(p);
 
-    Matcher matcher{};
-    matcher.path = this;
-    matcher.xyz = &xyz;
+    }
 
-    // get bounds
-    auto b = matcher.bounds();
+}
 
-    // get bounds
-    double b0 = b.x + 1e-12;
-    double b1 = b.y - 1e-12;
+
+double Path::match(const base::Vector3 &xyz, double &s, double radius) const {
 
     // set radius at least to a minimum
     radius = fmax(0.1, std::abs(radius));
 
-    // calculate minimum on discrete steps
-    auto ss = base::maxspace(fmax(s - radius, b0), fmin(s + radius, b1), 10.0);
+    // get search range
+    double s0 = fmax(s - radius, -distanceToBack());
+    double s1 = fmin(s + radius, distanceToHead());
+
+    // get position of the first segment relative to the current position
+    double offset = -_s;
+    for (auto it = _segments.begin(); it != _it; ++it)
+        offset -= (*it)->length();
+
     double erro = INFINITY;
+    double sm = s;
+
+    // project point on the segments within the search range
+    for (auto it = _segments.begin(); it != _segments.end(); offset += (*it)->length(), ++it) {
+
+        auto edge = *it;
 
-    for(size_t i = 0; i < ss.size(); ++i) {
+        // get range within the segment
+        double e0 = fmax(s0 - offset, 0.0);
+        double e1 = fmin(s1 - offset, edge->length());
+        if (e0 > e1)
+            continue;
 
-        double err = INFINITY;
-        matcher.operator()(ss[i], err);
+        // project and limit to range
+        double d = 0.0;
+        auto se = edge->project(xyz, d, fmin(e1, fmax(e0, s - offset)));
+        se = fmin(e1, fmax(e0, se));
 
-        if(err < erro) {
-            s = ss[i];
+        // calculate error
+        auto diff = edge->position(se).position - xyz;
+        auto err = diff.x * diff.x + diff.y * diff.y + diff.z * diff.z;
+
+        if (err < erro) {
+            sm = offset + se;
             erro = err;
         }
 
     }
 
-    return matchExec(&matcher, &s, base::EPS_DISTANCE, base::EPS_DISTANCE, 1000);
+    s = sm;
+    return erro;
+
+}
+
+
+std::list<Path::Neighbor> Path::neighboredPaths(const Track &track) const {
+
+    // compile track and find the current road
+    Route route(track);
+    auto index = route.find(position().edge()->trackElement());
+
+    return neighboredPaths(route, index == route.size() ? 0 : index);
 
 }
 
 
-std::list<Path::Neighbor> Path::neighboredPaths(Track &track) const {
+std::list<Path::Neighbor> Path::neighboredPaths(const Route &route, size_t index) const {
 
     // create container
     std::list<Neighbor> ret{};
@@ -392,20 +460,20 @@ std::list<Path::Neighbor> Path::neighboredPaths(Track &track) const {
     auto pos = position();
     pos.d(0.0);
 
-    // copy track
-    auto revTrack = track;
-    revTrack.reverseTrack();
+    // reversed route (the index of the current road is mirrored)
+    auto revRoute = route.opposite();
+    auto revIndex = route.empty() ? 0 : route.size() - 1 - index;
 
     // pre-calculate stuff
     double dh = distanceToHead();
     double db = distanceToBack();
 
-    // get left lane and direction
+    // get left lane and direction (the n-th neighbor is taken from the strip of the position)
     auto dir = pos.edge()->isForward();
-    auto mc = pos.left();
+    size_t i = 1;
+    auto mc = pos.left(i);
 
     // get left paths
-    size_t i = 1;
     while(!mc.outOfRoad()) {
 
         // create path
@@ -428,17 +496,14 @@ std::list<Path::Neighbor> Path::neighboredPaths(Track &track) const {
         ret.emplace_back(info, p);
 
         // when direction changes
-        if(info.sameDir) {
-
-            Path::create(ret.back().second, track, dh, db, mc);
-            mc = mc.left();
+        auto k = info.sameDir ? index : revIndex;
+        if(info.sameDir)
+            Path::create(ret.back().second, route, k, dh, db, mc);
+        else
+            Path::create(ret.back().second, *revRoute, k, db, dh, mc);
 
-        } else {
-
-            Path::create(ret.back().second, revTrack, db, dh, mc);
-            mc = mc.right();
-
-        }
+        // next lane to the left
+        mc = pos.left(i);
 
     }
 
@@ -446,11 +511,10 @@ std::list<Path::Neighbor> Path::neighboredPaths(Track &track) const {
     ret.reverse();
 
     // reset values
-    mc = pos.right();
-    dir = pos.edge()->isForward();
+    i = 1;
+    mc = pos.right(i);
 
     // get right pathes
-    i = 1;
     while(!mc.outOfRoad()) {
 
         // calculate index
@@ -473,17 +537,14 @@ std::list<Path::Neighbor> Path::neighboredPaths(Track &track) const {
         ret.emplace_back(info, p);
 
         // when direction changes
-        if(info.sameDir) {
+        auto k = info.sameDir ? index : revIndex;
+        if(info.sameDir)
+            Path::create(ret.back().second, route, k, dh, db, mc);
+        else
+            Path::create(ret.back().second, *revRoute, k, db, dh, mc);
 
-            Path::create(ret.back().second, track, dh, db, mc);
-            mc = mc.right();
-
-        } else {
-
-            Path::create(ret.back().second, revTrack, db, dh, mc);
-            mc = mc.left();
-
-        }
+        // next lane to the right
+        mc = pos.right(i);
 
     }
 
@@ -558,100 +619,6 @@ std::vector<double> Path::distance(const MapCoordinate &mc) const {
 
 }
 
-
-double Path::matchExec(const Path::Matcher *matcher, double *s, double s_eps, double f_eps, size_t max_f) {
-
-    double err = INFINITY;
-    double delta_s = INFINITY;
-
-    // get boundaries
-    auto bnds = matcher->bounds();
-    size_t i = 0;
-
-    while(err > f_eps && std::abs(delta_s) > s_eps) {
-
-        // calculate position and error
-        auto pos = matcher->operator()(*s, err);
-
-        auto loc = base::toLocal(pos, *matcher->xyz);
-        delta_s = loc.x;
-
-        // calculate delta s
-        *s += delta_s;
-
-        // apply boundaries
-        *s = fmax(*s, bnds.x);
-        *s = fmin(*s, bnds.y);
-
-        // check number of evaluations
-        if(++i >= max_f)
-            break;
-
-    }
-
-    return err;
-
-}
-
-
-void Path::extendRecursively(std::list<Path *> &paths, double len) {
-
-    if(len <= 0.0)
-        return;
-
-    // get last element
-    auto path = paths.back();
-
-    // get connections
-    auto conPtr = &path->_segments.back()->nexts();
-
-    // check if empty (then abort)
-    if(conPtr->empty())
-        return;
-
-    // reinterpret to LaneEdge vector
-    auto next = reinterpret_cast<const std::vector<std::pair<base::ContactPoint, LaneEdge*>>*>(conPtr);
-
-    // remove element from vector
-    paths.pop_back();
-
-    // iterate over successors
-    bool any = false;
-    for(const auto edge : *next) {
-
-        // get edge
-        auto e = edge.second;
-
-        /*
-         * TODO:
-         * // check if edge is a start edge and the same road as first edge
-         * if(e->startOfRoad() && path->hasRoad(e->trackElement()))
-         *    continue;
-         */
-
-        // copy path and add edge
-        auto pn = new Path(*path);
-        pn->_segments.push_back(e);
-
-        // add path to vector
-        paths.push_back(pn);
-
-        // recursion
-        extendRecursively(paths, len - e->length());
-
-        // set flag
-        any = true;
-
-    }
-
-    // if path was continued, delete, if not safe back to vector (end of path)
-    if(any)
-        delete path;
-    else
-        paths.push_back(path);
-
-}
-
 }
 }
 
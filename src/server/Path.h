@@ -29,6 +29,7 @@
 #include <graph/Path.h>
 #include <graph/Graph.h>
 #include "LaneEdge.h"
+#include "Route.h"
 #include "Track.h"
 
 namespace simmap {
@@ -41,9 +42,10 @@ class Track;
 
 /**
  * class Path
+ * The path stores the lanes as LaneEdge pointers, the accessors do not need to cast the edges.
  * @author Jens Klimke jens.klimke@rwth-aachen.de
  */
-class Path : public ::graph::Path {
+class Path : public ::graph::TypedPath<LaneEdge> {
 
 public:
 
@@ -64,17 +66,6 @@ public:
 protected:
 
 
-    struct Matcher {
-
-        const Path *path;
-        const base::Vector3 *xyz;
-
-        base::CurvePoint operator()(double s, double &d) const;
-        base::Vector3 bounds() const;
-
-    };
-
-
     /* Attributes */
 
     double _d = 0.0;
@@ -107,6 +98,16 @@ public:
     void updatePath(double lenHead, double lenBack, Track &track);
 
 
+    /**
+     * Updates the path by adding edges along the route until the lengths are reached
+     * @param lenHead Length of the path to the head
+     * @param lenBack Length of the path to the back
+     * @param route Route
+     * @param index Index of the road of the current position in the route (updated to the current road)
+     */
+    void updatePath(double lenHead, double lenBack, const Route &route, size_t &index);
+
+
     /**
      * Updates the current position by a long. position in the path
      * @param s New position
@@ -172,7 +173,21 @@ public:
 
 
     /**
-     * Creates all pathes beginning from the given point. The function also checks for loops
+     * Creates a path along the route
+     * @param path The created path
+     * @param route The route on which the path shall be followed
+     * @param index Index of the road of the position in the route (updated to the road of the position)
+     * @param lenHead Length of the path to the front (positive)
+     * @param lenBack Length of the path to the back (also positive!)
+     * @param position Start coordinate
+     */
+    static void create(Path &path, const Route &route, size_t &index, double lenHead, double lenBack,
+                       const MapCoordinate &position);
+
+
+    /**
+     * Creates all pathes beginning from the given point (one for each leaf of the horizon tree of the edge). The
+     * function also checks for loops
      * @param paths Vector in which the paths are stored
      * @param edge Edge to be started
      * @param len The maximum length of the paths
@@ -194,7 +209,16 @@ public:
      * Creates a list of neighbored paths along the track
      * @return List of paths
      */
-    std::list<Neighbor> neighboredPaths(Track &track) const;
+    std::list<Neighbor> neighboredPaths(const Track &track) const;
+
+
+    /**
+     * Creates a list of neighbored paths along the route
+     * @param route Route
+     * @param index Index of the road of the current position in the route
+     * @return List of paths
+     */
+    std::list<Neighbor> neighboredPaths(const Route &route, size_t index) const;
 
 
     /**
@@ -232,31 +256,11 @@ protected:
     /**
      * Extends the path to reach the distance
      * @param ds Distance
-     * @param track Track
-     * @param trackIndex Index of the current track element
+     * @param route Route
+     * @param routeIndex Index of the current road in the route
      * TODO: test this extensively (some changes done)
      */
-    void extendPath(double ds, const Track &track, size_t &trackIndex);
-
-
-    /**
-     * Extends the given path recursively by creating an copy and adding segments
-     * @param paths Vector in which the paths are stored
-     * @param len Maximum length
-     */
-    static void extendRecursively(std::list<Path *> &paths, double len);
-
-
-    /**
-     * Executes a match algorithm
-     * @param matcher Matcher struct
-     * @param s Initial position (will be updated)
-     * @param s_eps Minimum step residuum
-     * @param f_eps Minimum function residuum
-     * @param max_f Maximum number of evaluations
-     * @return Final error
-     */
-    static double matchExec(const Path::Matcher *matcher, double *s, double s_eps, double f_eps, size_t max_f);
+    void extendPath(double ds, const Route &route, size_t &routeIndex);
 
 
 };
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-21.
+//
+
+
+#include "Route.h"
+#include <base/functions.h>
+#include <graph/Edge.h>
+
+
+namespace simmap {
+namespace server {
+
+
+    Route::Route(const Track &track) {
+
+        _entries.reserve(track.size());
+
+        for (const auto &e : track) {
+
+            _index[e].push_back(_entries.size());
+            _entries.push_back(Entry{e, _length});
+
+            // update length
+            if (e.second != nullptr)
+                _length += e.second->length();
+
+        }
+
+    }
+
+
+    std::shared_ptr<const Route> Route::compile(const Track &track) {
+
+        auto route = std::make_shared<Route>(track);
+        route->_opposite = std::make_shared<const Route>(route->reversed());
+
+        return route;
+
+    }
+
+
+    size_t Route::size() const {
+
+        return _entries.size();
+
+    }
+
+
+    bool Route::empty() const {
+
+        return _entries.empty();
+
+    }
+
+
+    double Route::length() const {
+
+        return _length;
+
+    }
+
+
+    const Route::Entry &Route::operator[](size_t i) const {
+
+        return _entries[i];
+
+    }
+
+
+    size_t Route::next(size_t i) const {
+
+        return (i + 1) % _entries.size();
+
+    }
+
+
+    size_t Route::previous(size_t i) const {
+
+        return (i + _entries.size() - 1) % _entries.size();
+
+    }
+
+
+    size_t Route::find(const Track::TrackElement &element, size_t from) const {
+
+        auto it = _index.find(element);
+        if (it == _index.end())
+            return _entries.size();
+
+        // first occurrence at or behind the start index (wrap around otherwise)
+        for (auto i : it->second) {
+            if (i >= from)
+                return i;
+        }
+
+        return it->second.front();
+
+    }
+
+
+    Route Route::reversed() const {
+
+        Track track{};
+        for (auto it = _entries.rbegin(); it != _entries.rend(); ++it)
+            track.push_back(Track::TrackElement{base::flip(it->element.first), it->element.second});
+
+        return Route(track);
+
+    }
+
+
+    std::shared_ptr<const Route> Route::opposite() const {
+
+        return _opposite ? _opposite : std::make_shared<const Route>(reversed());
+
+    }
+
+
+    Track Route::track() const {
+
+        Track track{};
+        for (const auto &e : _entries)
+            track.push_back(e.element);
+
+        return track;
+
+    }
+
+
+
+    std::shared_ptr<const Route> RouteCache::route(const Track &track) {
+
+        auto it = _routes.find(track);
+        if (it != _routes.end()) {
+
+            auto route = it->second.lock();
+            if (route)
+                return route;
+
+        }
+
+        // remove released routes
+        for (auto r = _routes.begin(); r != _routes.end();) {
+            if (r->second.expired())
+                r = _routes.erase(r);
+            else
+                ++r;
+        }
+
+        auto route = Route::compile(track);
+        _routes[track] = route;
+
+        return route;
+
+    }
+
+
+    size_t RouteCache::size() const {
+
+        return _routes.size();
+
+    }
+
+
+    void RouteCache::clear() {
+
+        _routes.clear();
+
+    }
+
+}} // namespace ::simmap::server
@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-21.
+//
+
+
+#ifndef SIMMAP_SERVER_ROUTE_H
+#define SIMMAP_SERVER_ROUTE_H
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "Track.h"
+
+namespace simmap {
+namespace server {
+
+
+    /**
+     * @brief Compiled track
+     * The roads of a track are stored in a contiguous array with the cumulative lengths, the index of a road is found
+     * by a hash table. Like the track, the route is closed, i.e. the first road follows the last road. The progress of
+     * an agent along the route is stored as an index instead of rotating the track.
+     */
+    class Route {
+
+    public:
+
+        /** Struct to define a road of the route */
+        struct Entry {
+            Track::TrackElement element;    /**< the road and the orientation */
+            double start;                   /**< the length of the route before the road */
+        };
+
+
+    private:
+
+        /** Hash of a track element */
+        struct Hash {
+            size_t operator()(const Track::TrackElement &e) const {
+                return std::hash<const void *>()(e.second) ^ static_cast<size_t>(e.first);
+            }
+        };
+
+        std::vector<Entry> _entries{};
+        std::unordered_map<Track::TrackElement, std::vector<size_t>, Hash> _index{};
+
+        double _length = 0.0;
+
+        std::shared_ptr<const Route> _opposite{};   // precompiled route in the opposite direction
+
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        Route() = default;
+
+
+        /**
+         * Compiles the given track
+         * @param track Track
+         */
+        explicit Route(const Track &track);
+
+
+        /**
+         * Compiles the given track and the track in the opposite direction
+         * @param track Track
+         * @return Route (immutable, to be shared)
+         */
+        static std::shared_ptr<const Route> compile(const Track &track);
+
+
+        /**
+         * Returns the number of roads
+         * @return Number of roads
+         */
+        size_t size() const;
+
+
+        /**
+         * Checks whether the route is empty
+         * @return Flag whether the route is empty
+         */
+        bool empty() const;
+
+
+        /**
+         * Returns the length of the route
+         * @return Length
+         */
+        double length() const;
+
+
+        /**
+         * Returns the road with the given index
+         * @param i Index
+         * @return Road
+         */
+        const Entry &operator[](size_t i) const;
+
+
+        /**
+         * Returns the index of the next road
+         * @param i Index
+         * @return Index of the next road (the first road follows the last road)
+         */
+        size_t next(size_t i) const;
+
+
+        /**
+         * Returns the index of the previous road
+         * @param i Index
+         * @return Index of the previous road (the last road precedes the first road)
+         */
+        size_t previous(size_t i) const;
+
+
+        /**
+         * Searches the given road (the first occurrence starting with the given index)
+         * @param element Road
+         * @param from Index to start the search
+         * @return Index of the road (size() if the road is not part of the route)
+         */
+        size_t find(const Track::TrackElement &element, size_t from = 0) const;
+
+
+        /**
+         * Returns the route in the opposite direction (the road with index i has the index size() - 1 - i)
+         * @return Reversed route
+         */
+        Route reversed() const;
+
+
+        /**
+         * Returns the route in the opposite direction (precompiled if created by compile, compiled otherwise)
+         * @return Reversed route
+         */
+        std::shared_ptr<const Route> opposite() const;
+
+
+        /**
+         * Returns the roads as track
+         * @return Track
+         */
+        Track track() const;
+
+    };
+
+
+    /**
+     * @brief Registry of the compiled routes
+     * Routes are deduplicated by the roads of the track, i.e. agents with identical tracks share the same route. The
+     * registry does not own the routes, a route is released when the last agent drops it.
+     */
+    class RouteCache {
+
+        std::map<Track, std::weak_ptr<const Route>> _routes{};
+
+    public:
+
+        /**
+         * Default constructor
+         */
+        RouteCache() = default;
+
+
+        /**
+         * Returns the route of the given track (compiled, if not shared yet)
+         * @param track Track
+         * @return Route
+         */
+        std::shared_ptr<const Route> route(const Track &track);
+
+
+        /**
+         * Returns the number of registered routes (including released routes not removed yet)
+         * @return Number of routes
+         */
+        size_t size() const;
+
+
+        /**
+         * Removes all routes from the registry
+         */
+        void clear();
+
+    };
+
+}} // namespace ::simmap::server
+
+#endif // SIMMAP_SERVER_ROUTE_H
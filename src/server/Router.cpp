@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-18.
+//
+
+#include "Router.h"
+#include "LaneEdge.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <stdexcept>
+
+
+namespace simmap {
+namespace server {
+
+
+    bool Router::lanes(const LaneEdge *start, double s0, const LaneEdge *target, double s1,
+                       std::vector<const LaneEdge *> &lanes) {
+
+        lanes.clear();
+
+        // target in front of the start position
+        if (start == target && s1 >= s0) {
+            lanes.push_back(start);
+            return true;
+        }
+
+        /** A lane entered at the given position */
+        typedef std::pair<const LaneEdge *, double> Node;
+
+        /** Struct to define a label of the search */
+        struct Label {
+            double f;                       /**< the estimated total cost */
+            double v;                       /**< the cost to the start of the lane */
+            Node node;                      /**< the lane and the entry position (nullptr lane for the target) */
+            bool operator>(const Label &l) const { return f > l.f; }
+        };
+
+        std::priority_queue<Label, std::vector<Label>, std::greater<Label>> queue{};
+        std::map<Node, double> best{};
+        std::map<Node, Node> parent{};
+
+        // heuristic (euclidean distance to the target)
+        auto goal = target->position(s1).position;
+        auto h = [&goal](const Node &n) {
+            auto p = n.first->position(n.second).position;
+            return std::sqrt((p.x - goal.x) * (p.x - goal.x) + (p.y - goal.y) * (p.y - goal.y));
+        };
+
+        // adds a label, if the node is reached cheaper than before
+        auto relax = [&](const Node &from, const Node &to, double v) {
+
+            auto it = best.find(to);
+            if (it != best.end() && it->second <= v + base::EPS_DISTANCE)
+                return;
+
+            best[to] = v;
+            parent[to] = from;
+            queue.push(Label{v + to.second + h(to), v, to});
+
+        };
+
+        // start node (the cost is related to the start of the lane)
+        Node source{start, s0};
+        best[source] = -s0;
+        queue.push(Label{0.0, -s0, source});
+
+        bool found = false;
+        Node last{nullptr, 0.0};
+        while (!queue.empty()) {
+
+            auto l = queue.top();
+            queue.pop();
+
+            // target reached
+            if (l.node.first == nullptr) {
+                last = parent.at(l.node);
+                found = true;
+                break;
+            }
+
+            // ignore outdated labels
+            if (l.v > best.at(l.node) + base::EPS_DISTANCE)
+                continue;
+
+            auto e = l.node.first;
+            auto entry = l.node.second;
+
+            auto adjacency = e->adjacency();
+            if (adjacency == nullptr)
+                throw std::runtime_error("lane is not indexed (see graph::Graph::index)");
+
+            // add target (if in front of the entry position)
+            if (e == target && s1 >= entry && l.node != source) {
+
+                Node t{nullptr, entry};
+                parent[t] = l.node;
+                queue.push(Label{l.v + s1, l.v + s1, t});
+
+            }
+
+            // successors
+            for (const auto &c : adjacency->nexts(e->handle()))
+                relax(l.node, Node{static_cast<const LaneEdge *>(c.edge), 0.0}, l.v + e->length());
+
+            // lane changes (only to lanes of the same direction)
+            for (auto side : {graph::Neighbored::Side::LEFT, graph::Neighbored::Side::RIGHT}) {
+
+                auto n = adjacency->neighbor(e->handle(), entry, side);
+                auto lane = static_cast<const LaneEdge *>(n.second);
+
+                if (lane != nullptr && lane->isForward() == e->isForward())
+                    relax(l.node, Node{lane, n.first}, l.v + entry + ROUTER_LANE_CHANGE_COST - n.first);
+
+            }
+
+        }
+
+        if (!found)
+            return false;
+
+        // collect lanes backwards
+        for (auto n = last; n != source; n = parent.at(n))
+            lanes.push_back(n.first);
+
+        lanes.push_back(start);
+        std::reverse(lanes.begin(), lanes.end());
+
+        return true;
+
+    }
+
+
+    bool Router::route(const LaneEdge *start, double s0, const LaneEdge *target, double s1, Track &track) {
+
+        std::vector<const LaneEdge *> route{};
+        if (!lanes(start, s0, target, s1, route))
+            return false;
+
+        // collect roads
+        track.clear();
+        for (auto e : route) {
+
+            auto element = e->trackElement();
+            if (track.empty() || track.back() != element)
+                track.push_back(element);
+
+        }
+
+        return true;
+
+    }
+
+}} // namespace ::simmap::server
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-18.
+//
+
+#ifndef SIMMAP_SERVER_ROUTER_H
+#define SIMMAP_SERVER_ROUTER_H
+
+#include <vector>
+#include "Track.h"
+
+#ifndef ROUTER_LANE_CHANGE_COST
+#define ROUTER_LANE_CHANGE_COST 10.0 // cost of a lane change in the routing (in m)
+#endif
+
+namespace simmap {
+namespace server {
+
+    struct LaneEdge;
+
+
+    /**
+     * @brief Router on the lane network
+     * Finds the shortest route between two lane positions by A* on the lanes. The lanes are connected by the
+     * successors (nexts) and by lane changes to the neighbored lanes of the same direction (at the entry position of a
+     * lane). The heuristic is the euclidean distance to the target position.
+     */
+    class Router {
+
+    public:
+
+        /**
+         * Finds the shortest sequence of lanes from the start to the target position
+         * @param start Start lane
+         * @param s0 Position in the start lane
+         * @param target Target lane
+         * @param s1 Position in the target lane
+         * @param lanes Lanes of the route (including the start and the target lane)
+         * @return Flag whether a route was found
+         */
+        static bool lanes(const LaneEdge *start, double s0, const LaneEdge *target, double s1,
+                          std::vector<const LaneEdge *> &lanes);
+
+
+        /**
+         * Finds the shortest route from the start to the target position and returns the roads of the route
+         * @param start Start lane
+         * @param s0 Position in the start lane
+         * @param target Target lane
+         * @param s1 Position in the target lane
+         * @param track Roads of the route (with orientation)
+         * @return Flag whether a route was found
+         */
+        static bool route(const LaneEdge *start, double s0, const LaneEdge *target, double s1, Track &track);
+
+    };
+
+}} // namespace ::simmap::server
+
+#endif // SIMMAP_SERVER_ROUTER_H
@@ -24,12 +24,21 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <list>
+#include <limits>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
 
 #include <server/Map.h>
 #include <server/Path.h>
+#include <server/Router.h>
 #include <server/MapCoordinate.h>
 #include <base/functions.h>
+#include <base/metrics.h>
 #include <odradapter/ODRAdapter.h>
 #include <simmap/simmap.h>
 
@@ -45,15 +54,118 @@ namespace simmap {
     struct Agent {
         Map *map = nullptr;
         Path path;
-        Track track{};
+        std::shared_ptr<const Route> route = std::make_shared<const Route>(); // compiled track (shared)
+        size_t progress = 0;                                                  // index of the current road in the route
+        double hysteresis = 1.0;                                              // high-water factor of the path lengths
+        double requested[2] = {0.0, 0.0};                                     // path lengths requested for the hysteresis
     };
 
     static std::map<id_type_t, Map *>   _maps;   // Segment ID -> Map Segment
     static std::map<id_type_t, Agent *> _agents; // Agent ID   -> Map Segment
 
+    static std::map<id_type_t, std::future<Map *>> _loading; // Segment ID -> Map Segment being loaded
+    static std::set<id_type_t> _failed;                          // Segment IDs of failed loads
+    static std::list<std::future<Map *>> _discarded;             // Maps unloaded while being loaded
+
     static id_type_t _seg_id_counter = 0;
 
 
+    // metrics of the library functions
+    enum class _Function {
+        CLEAR, LOAD_MAP, LOAD_MAP_ASYNC, MAP_STATUS, UNLOAD_MAP, REGISTER_AGENT, UNREGISTER_AGENT, SET_TRACK,
+        GET_POSITION, SET_MAP_POSITION, GET_MAP_POSITION, MATCH, MOVE, SWITCH_LANE, HORIZON, OBJECTS, LANES, TARGETS,
+        LOCATE, MATCH_GLOBAL, ROUTE, EDGE_HANDLE, ROAD_HANDLE, HORIZON_TREE,
+        SET_PATH_HYSTERESIS
+    };
+
+    static base::metrics::CallTable _metrics{{
+        "clear", "loadMap", "loadMapAsync", "mapStatus", "unloadMap", "registerAgent", "unregisterAgent", "setTrack",
+        "getPosition", "setMapPosition", "getMapPosition", "match", "move", "switchLane", "horizon", "objects",
+        "lanes", "targets", "locate", "matchGlobal", "route", "edgeHandle", "roadHandle", "horizonTree",
+        "setPathHysteresis"
+    }};
+
+    static base::metrics::CodeCounter<512> _errorCodes{}; // Error code -> number of occurrences (codes < 512)
+
+
+    template<typename F>
+    err_type_t _measure(_Function fn, F f) {
+
+        auto start = base::metrics::CallTable::clock::now();
+        auto err = f();
+
+        // record call and error code
+        _metrics.record(static_cast<size_t>(fn), start, err != 0);
+        if (err != 0)
+            _errorCodes.increment(err);
+
+        return err;
+
+    }
+
+
+    void _harvestMaps() {
+
+        auto it = _loading.begin();
+        while (it != _loading.end()) {
+
+            // check if loading is finished
+            if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            try {
+
+                // move map to storage
+                auto map = it->second.get();
+                _maps[it->first] = map;
+
+            } catch (const std::exception &e) {
+
+                // print error and mark map as failed
+                std::cerr << e.what() << std::endl;
+                _failed.insert(it->first);
+
+            }
+
+            // remove from loading list
+            it = _loading.erase(it);
+
+        }
+
+        // delete discarded maps, when loading is finished
+        auto itd = _discarded.begin();
+        while (itd != _discarded.end()) {
+
+            if (itd->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++itd;
+                continue;
+            }
+
+            try {
+                delete itd->get();
+            } catch (const std::exception &) {
+                // failed loads are ignored
+            }
+
+            itd = _discarded.erase(itd);
+
+        }
+
+    }
+
+
+    void _discardLoading(id_type_t id) {
+
+        // keep the future until loading is finished (the destructor of the future would wait)
+        auto it = _loading.find(id);
+        _discarded.push_back(std::move(it->second));
+        _loading.erase(it);
+
+    }
+
+
     err_type_t _basicCheckAgent(id_type_t agentID, Agent **ag) {
 
         try {
@@ -114,6 +226,43 @@ namespace simmap {
 
     }
 
+
+    err_type_t _basicMapCoordinate(id_type_t agentID, const MapHandlePosition &mapPos, Agent **ag, MapCoordinate *mc) {
+
+        // check if agent already registered
+        auto err = _basicCheckAgent(agentID, ag);
+        if (err != 0)
+            return err;
+
+        // get edge
+        auto edge = (*ag)->map->getEdge(static_cast<size_t>(mapPos.edge));
+        if (edge == nullptr)
+            return 20;
+
+        // create map coordinate
+        *mc = MapCoordinate(edge, mapPos.longPos, mapPos.latPos);
+        return 0;
+
+    }
+
+
+    void _copyMapPosition(const MapCoordinate &mc, MapPosition &mapPos) {
+
+        mapPos.edgeID = mc.edge()->id().c_str();
+        mapPos.latPos = mc.d();
+        mapPos.longPos = mc.s();
+
+    }
+
+
+    void _copyMapPosition(const MapCoordinate &mc, MapHandlePosition &mapPos) {
+
+        mapPos.edge = mc.edge()->handle();
+        mapPos.latPos = mc.d();
+        mapPos.longPos = mc.s();
+
+    }
+
     std::pair<ObjectType, int> _getObjectType(const graph::Object *obj) {
 
         if (obj->getType() != "signal")
@@ -196,13 +345,19 @@ namespace simmap {
     }
 
 
-    err_type_t clear() {
+    err_type_t _clear() {
 
 
         const int ERR = 10;
 
         try {
 
+            // discard maps being loaded (not waited for)
+            while (!_loading.empty())
+                _discardLoading(_loading.begin()->first);
+
+            _harvestMaps();
+
             // delete networks
             for (auto &nw : _maps)
                 delete nw.second;
@@ -214,6 +369,7 @@ namespace simmap {
             // clear containers
             _maps.clear();
             _agents.clear();
+            _failed.clear();
 
             // reset ID counter
             _seg_id_counter = 0;
@@ -228,7 +384,7 @@ namespace simmap {
     }
 
 
-    err_type_t loadMap(const char *filename, id_type_t &id) {
+    err_type_t _loadMap(const char *filename, MapOptions options, id_type_t &id) {
 
         const int ERR = 20;
 
@@ -252,7 +408,7 @@ namespace simmap {
             try {
 
                 // create network
-                map->loadFile(filename);
+                map->loadFile(filename, options.curveTolerance, options.routingHierarchy != 0);
 
             }  catch (const std::exception &e) {
 
@@ -282,12 +438,83 @@ namespace simmap {
     }
 
 
-    err_type_t unloadMap(id_type_t id) {
+    err_type_t _loadMapAsync(const char *filename, MapOptions options, id_type_t &id) {
+
+        const int ERR = 170;
+
+        try {
+
+            // reserve segment id
+            id = ++_seg_id_counter;
+
+            // load map file in background
+            _loading[id] = std::async(std::launch::async, [](const std::string &fn, MapOptions opt) -> Map * {
+
+                std::unique_ptr<odra::ODRAdapter> map(new odra::ODRAdapter);
+                map->loadFile(fn, opt.curveTolerance, opt.routingHierarchy != 0);
+
+                return map.release();
+
+            }, std::string(filename), options);
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    err_type_t _mapStatus(id_type_t id, MapStatus &status) {
+
+        const int ERR = 180;
+
+        try {
+
+            // check finished maps
+            _harvestMaps();
+
+            // get status
+            if (_maps.find(id) != _maps.end())
+                status = MapStatus::READY;
+            else if (_loading.find(id) != _loading.end())
+                status = MapStatus::LOADING;
+            else if (_failed.find(id) != _failed.end())
+                status = MapStatus::FAILED;
+            else
+                return ERR + 5;
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    err_type_t _unloadMap(id_type_t id) {
 
         const int ERR = 30;
 
         try {
 
+            // check finished maps
+            _harvestMaps();
+
+            // discard the map, if currently loaded (deleted, when loading is finished)
+            if (_loading.find(id) != _loading.end()) {
+                _discardLoading(id);
+                return 0;
+            }
+
+            // forget failed map
+            if (_failed.erase(id) != 0)
+                return 0;
+
             // get segment
             if (_maps.find(id) == _maps.end())
                 return ERR + 5;
@@ -331,7 +558,7 @@ namespace simmap {
     }
 
 
-    err_type_t registerAgent(id_type_t agentID, id_type_t mapID) {
+    err_type_t _registerAgent(id_type_t agentID, id_type_t mapID) {
 
         const int ERR = 40;
 
@@ -341,6 +568,13 @@ namespace simmap {
             if (_agents.find(agentID) != _agents.end())
                 return ERR + 5;
 
+            // check finished maps
+            _harvestMaps();
+
+            // check if map is still loaded
+            if (_loading.find(mapID) != _loading.end())
+                return ERR + 7;
+
             // check if map exists
             if (_maps.find(mapID) == _maps.end())
                 return ERR + 6;
@@ -362,7 +596,7 @@ namespace simmap {
     }
 
 
-    err_type_t unregisterAgent(id_type_t agentID) {
+    err_type_t _unregisterAgent(id_type_t agentID) {
 
         const int ERR = 50;
 
@@ -389,7 +623,7 @@ namespace simmap {
     }
 
 
-    err_type_t setTrack(id_type_t agentID, const char **trackElements, unsigned long n) {
+    err_type_t _setTrack(id_type_t agentID, const char **trackElements, unsigned long n) {
 
         const int ERR = 60;
 
@@ -401,8 +635,10 @@ namespace simmap {
             if (err != 0)
                 return ERR + err;
 
-            // get track and empty
-            ag->track.clear();
+            // empty track
+            Track track{};
+            ag->route = std::make_shared<const Route>();
+            ag->progress = 0;
 
             // get segment
             auto *map = _agents.at(agentID)->map;
@@ -426,15 +662,18 @@ namespace simmap {
                 }
 
                 // check if road exists
-                if (map->_roadNetwork.find(id) == map->_roadNetwork.end())
+                auto road = map->_roadNetwork.edge(map->_roadNetwork.handle(id));
+                if (road == nullptr)
                     return ERR + 5;
 
-                // get road and add to track
-                auto road = map->_roadNetwork.at(id);
-                ag->track.push_back(simmap::server::Track::TrackElement{ori, road.get()});
+                // add road to track
+                track.push_back(simmap::server::Track::TrackElement{ori, road});
 
             }
 
+            // get compiled track (shared by the agents with the same track)
+            ag->route = ag->map->_routes.route(track);
+
         } catch (const std::exception &e) {
             std::cerr << e.what() << std::endl;
             return ERR + 9;
@@ -445,7 +684,7 @@ namespace simmap {
     }
 
 
-    err_type_t getPosition(id_type_t agentID, Position &pos) {
+    err_type_t _getPosition(id_type_t agentID, Position &pos) {
 
         const int ERR = 70;
 
@@ -458,7 +697,7 @@ namespace simmap {
                 return ERR + err;
 
             // get agent and check track
-            if (ag->track.empty())
+            if (ag->route->empty())
                 return ERR + 5; // track not set
 
             // get map position and absolute position
@@ -483,7 +722,52 @@ namespace simmap {
     }
 
 
-    err_type_t setMapPosition(id_type_t agentID, MapPosition mapPos, double &lenFront, double &lenBack) {
+    err_type_t _setTrack(id_type_t agentID, const TrackHandle *roads, unsigned long n) {
+
+        const int ERR = 60;
+
+        try {
+
+            // check if agent already registered
+            Agent *ag = nullptr;
+            auto err = _basicCheckAgent(agentID, &ag);
+            if (err != 0)
+                return ERR + err;
+
+            // empty track
+            Track track{};
+            ag->route = std::make_shared<const Route>();
+            ag->progress = 0;
+
+            // iterate over roads
+            for (size_t i = 0; i < n; ++i) {
+
+                // check if road exists
+                auto road = ag->map->_roadNetwork.edge(static_cast<size_t>(roads[i].road));
+                if (road == nullptr)
+                    return ERR + 5;
+
+                // add road to track
+                auto ori = roads[i].backwards != 0 ? base::Orientation::BACKWARDS : base::Orientation::FORWARDS;
+                track.push_back(simmap::server::Track::TrackElement{ori, road});
+
+            }
+
+            // get compiled track (shared by the agents with the same track)
+            ag->route = ag->map->_routes.route(track);
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    template<typename P>
+    err_type_t _setMapPosition(id_type_t agentID, const P &mapPos, double &lenFront, double &lenBack) {
 
         const int ERR = 80;
 
@@ -504,7 +788,7 @@ namespace simmap {
             try {
 
                 // create path
-                Path::create(ag->path, ag->track, lenFront, lenBack, mc);
+                Path::create(ag->path, *ag->route, ag->progress, lenFront, lenBack, mc);
 
                 // set lengths
                 lenFront = ag->path.distanceToHead();
@@ -526,7 +810,8 @@ namespace simmap {
     }
 
 
-    err_type_t getMapPosition(id_type_t agentID, MapPosition &mapPos) {
+    template<typename P>
+    err_type_t _getMapPosition(id_type_t agentID, P &mapPos) {
 
         const int ERR = 90;
 
@@ -542,9 +827,7 @@ namespace simmap {
             auto mc = ag->path.position();
 
             // copy position
-            mapPos.edgeID = mc.edge()->id().c_str();
-            mapPos.latPos = mc.d();
-            mapPos.longPos = mc.s();
+            _copyMapPosition(mc, mapPos);
 
         } catch (const std::exception &e) {
             std::cerr << e.what() << std::endl;
@@ -556,7 +839,7 @@ namespace simmap {
     }
 
 
-    err_type_t match(id_type_t agentID, Position pos, double ds, MapPosition &mapPos) {
+    err_type_t _match(id_type_t agentID, Position pos, double ds, MapPosition &mapPos) {
 
         const int ERR = 100;
 
@@ -597,7 +880,7 @@ namespace simmap {
     }
 
 
-    err_type_t move(id_type_t agentID, double distance, double lateralPosition, double &lenFront, double &lenBack) {
+    err_type_t _move(id_type_t agentID, double distance, double lateralPosition, double &lenFront, double &lenBack) {
 
         const int ERR = 110;
 
@@ -625,8 +908,24 @@ namespace simmap {
 
             try {
 
+                // requested lengths are set with the hysteresis (the lengths passed to move are output only)
+                auto lf = ag->requested[0];
+                auto lr = ag->requested[1];
+
+                // lengths of the path (extended to the high-water mark below the requested lengths, trimmed to the
+                // requested lengths above the high-water mark)
+                auto f = ag->hysteresis;
+                auto dh = ag->path.distanceToHead();
+                auto db = ag->path.distanceToBack();
+
+                auto lh = dh < lf ? f * lf : (dh > f * lf ? lf : dh);
+                auto lb = db < lr ? f * lr : (db > f * lr ? lr : db);
+
                 // update path
-                ag->path.updatePath(lenFront, lenBack, ag->track);
+                if (f <= 1.0)
+                    ag->path.updatePath(lenFront, lenBack, *ag->route, ag->progress);
+                else if (lh != dh || lb != db)
+                    ag->path.updatePath(lh, lb, *ag->route, ag->progress);
 
             } catch (const std::exception &e) {
                 std::cerr << e.what() << std::endl;
@@ -637,7 +936,6 @@ namespace simmap {
             lenFront = ag->path.distanceToHead();
             lenBack = ag->path.distanceToBack();
 
-
         } catch (const std::exception &e) {
             std::cerr << e.what() << std::endl;
             return ERR + 9;
@@ -648,7 +946,7 @@ namespace simmap {
     }
 
 
-    err_type_t switchLane(id_type_t agentID, int laneOffset) {
+    err_type_t _switchLane(id_type_t agentID, int laneOffset) {
 
         const int ERR = 160;
 
@@ -662,7 +960,7 @@ namespace simmap {
 
             // iterate over neighbors
             // TODO: save neighbored lanes to efficiently search for targets (recalculate intelligently on position update)
-            for (const auto &p : ag->path.neighboredPaths(ag->track)) {
+            for (const auto &p : ag->path.neighboredPaths(*ag->route, ag->progress)) {
 
                 if(p.first.index == laneOffset) {
 
@@ -683,7 +981,7 @@ namespace simmap {
                     try {
 
                         // create path
-                        Path::create(ag->path, ag->track, lenFront, lenBack, p.second.position());
+                        Path::create(ag->path, *ag->route, ag->progress, lenFront, lenBack, p.second.position());
 
                     } catch (const std::exception &e) {
                         std::cerr << e.what() << std::endl;
@@ -708,7 +1006,7 @@ namespace simmap {
 
 
 
-    err_type_t horizon(id_type_t agentID, const double *gridPoints, HorizonInformation *horizon, unsigned long n) {
+    err_type_t _horizon(id_type_t agentID, const double *gridPoints, HorizonInformation *horizon, unsigned long n) {
 
         const int ERR = 120;
 
@@ -802,7 +1100,7 @@ namespace simmap {
     }
 
 
-    err_type_t objects(id_type_t agentID, ObjectInformation *obj, unsigned long &n) {
+    err_type_t _objects(id_type_t agentID, ObjectInformation *obj, unsigned long &n) {
 
         const int ERR = 130;
 
@@ -850,7 +1148,7 @@ namespace simmap {
     }
 
 
-    err_type_t lanes(id_type_t agentID, LaneInformation *lanes, unsigned long &n) {
+    err_type_t _lanes(id_type_t agentID, LaneInformation *lanes, unsigned long &n) {
 
         const int ERR = 140;
 
@@ -872,7 +1170,7 @@ namespace simmap {
 
             // iterate over neighbors
             // TODO: save neighbored lanes to efficiently search for targets (recalculate intelligently on position update)
-            for (const auto &p : ag->path.neighboredPaths(ag->track)) {
+            for (const auto &p : ag->path.neighboredPaths(*ag->route, ag->progress)) {
 
                 // check if lanes have same direction
                 auto sd = p.first.sameDir;
@@ -913,7 +1211,7 @@ namespace simmap {
     }
 
 
-    err_type_t targets(id_type_t agentID, TargetInformation *targets, unsigned long &n) {
+    err_type_t _targets(id_type_t agentID, TargetInformation *targets, unsigned long &n) {
 
         const int ERR = 150;
 
@@ -960,7 +1258,7 @@ namespace simmap {
             _getTargetsOnPath(pool, tars, ag->path, 0, true);
 
             // iterate over neighbored paths
-            for (const auto &p : ag->path.neighboredPaths(ag->track))
+            for (const auto &p : ag->path.neighboredPaths(*ag->route, ag->progress))
                 _getTargetsOnPath(pool, tars, p.second, p.first.index,
                                   p.second.position().edge()->isForward() == ag->path.position().edge()->isForward());
 
@@ -986,5 +1284,624 @@ namespace simmap {
 
     }
 
+
+
+    err_type_t _locate(id_type_t mapID, double x, double y, double heading, MapPosition *positions,
+                       unsigned long &n) {
+
+        const int ERR = 210;
+
+        try {
+
+            // check n
+            if (n == 0)
+                return ERR + 5;
+
+            // check finished maps
+            _harvestMaps();
+
+            // check if map exists
+            if (_loading.find(mapID) != _loading.end())
+                return ERR + 7;
+            else if (_maps.find(mapID) == _maps.end())
+                return ERR + 6;
+
+            // find lanes
+            auto candidates = _maps.at(mapID)->_laneIndex.locate(x, y, heading);
+
+            // copy
+            n = static_cast<unsigned long>(std::min<size_t>(n, candidates.size()));
+            for (size_t i = 0; i < n; ++i)
+                positions[i] = MapPosition{candidates[i].edge->id().c_str(), candidates[i].s, candidates[i].d};
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+
+    err_type_t _matchGlobal(id_type_t mapID, const Position *pos, MapPosition *mapPos, unsigned long n) {
+
+        const int ERR = 220;
+
+        try {
+
+            // check n
+            if (n == 0)
+                return ERR + 5;
+
+            // check finished maps
+            _harvestMaps();
+
+            // check if map exists
+            if (_loading.find(mapID) != _loading.end())
+                return ERR + 7;
+            else if (_maps.find(mapID) == _maps.end())
+                return ERR + 6;
+
+            const auto &index = _maps.at(mapID)->_laneIndex;
+
+            // match positions
+            bool all = true;
+            for (unsigned long i = 0; i < n; ++i) {
+
+                server::LaneIndex::Candidate c{};
+                if (!index.match(pos[i].x, pos[i].y, pos[i].phi, c)) {
+                    mapPos[i] = MapPosition{nullptr, 0.0, 0.0};
+                    all = false;
+                    continue;
+                }
+
+                mapPos[i] = MapPosition{c.edge->id().c_str(), c.s, c.d};
+
+            }
+
+            // check if all positions are matched
+            if (!all)
+                return ERR + 8;
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    err_type_t _route(id_type_t agentID, const char *targetEdge, double targetS) {
+
+        const int ERR = 230;
+
+        try {
+
+            // check if agent already registered
+            Agent *ag = nullptr;
+            auto err = _basicCheckAgent(agentID, &ag);
+            if (err != 0)
+                return ERR + err;
+
+            // get target edge
+            const LaneEdge *target;
+            if (_basicCheckEdge(ag, targetEdge, &target) != 0)
+                return ERR + 5;
+
+            // check if position is set
+            if (ag->path.empty())
+                return ERR + 6;
+
+            // find route from the current position
+            auto mc = ag->path.position();
+
+            // use the hierarchy for routes to other roads (if created)
+            const auto &hierarchy = ag->map->_hierarchy;
+            auto hierarchical = !hierarchy.empty() && mc.edge()->trackElement() != target->trackElement();
+
+            Track track{};
+            auto found = hierarchical
+                    ? hierarchy.route(mc.edge()->trackElement(), target->trackElement(), track)
+                    : server::Router::route(mc.edge(), mc.s(), target, targetS, track);
+
+            if (!found)
+                return ERR + 7;
+
+            // set lengths
+            double lenFront = ag->path.distanceToHead();
+            double lenBack = ag->path.distanceToBack();
+
+            // set track and create path along the new track
+            ag->route = ag->map->_routes.route(track);
+            ag->progress = 0;
+            ag->path = Path();
+
+            try {
+
+                // create path
+                Path::create(ag->path, *ag->route, ag->progress, lenFront, lenBack, mc);
+
+            } catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+                return ERR + 8;
+            }
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    err_type_t _basicHandle(id_type_t mapID, graph::Graph Map::*network, const char *id, unsigned long &handle) {
+
+        // check finished maps
+        _harvestMaps();
+
+        // check if map exists
+        if (_loading.find(mapID) != _loading.end())
+            return 7;
+        else if (_maps.find(mapID) == _maps.end())
+            return 6;
+
+        // get handle
+        auto h = (_maps.at(mapID)->*network).handle(id);
+        if (h == graph::Graph::NONE)
+            return 5;
+
+        handle = static_cast<unsigned long>(h);
+        return 0;
+
+    }
+
+
+    err_type_t _edgeHandle(id_type_t mapID, const char *edgeID, unsigned long &handle) {
+
+        const int ERR = 240;
+
+        try {
+
+            auto err = _basicHandle(mapID, &Map::_laneNetwork, edgeID, handle);
+            if (err != 0)
+                return ERR + err;
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    err_type_t _roadHandle(id_type_t mapID, const char *roadID, unsigned long &handle) {
+
+        const int ERR = 250;
+
+        try {
+
+            auto err = _basicHandle(mapID, &Map::_roadNetwork, roadID, handle);
+            if (err != 0)
+                return ERR + err;
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+
+    err_type_t _horizonTree(id_type_t agentID, double distance, unsigned long depth, HorizonTreeNode *nodes,
+                            unsigned long &n) {
+
+        const int ERR = 260;
+
+        try {
+
+            // check if agent already registered
+            Agent *ag = nullptr;
+            auto err = _basicCheckAgent(agentID, &ag);
+            if (err != 0)
+                return ERR + err;
+
+            // check n
+            if (n == 0)
+                return ERR + 5;
+
+            // check if position is set
+            if (ag->path.empty())
+                return ERR + 6;
+
+            // get memoized tree from the start of the current lane
+            auto mc = ag->path.position();
+            auto tree = ag->map->_horizonTrees.tree(mc.edge(), mc.s() + distance, depth);
+
+            // copy n to store max
+            auto max = n;
+            n = 0;
+
+            // copy nodes within the distance (the parent of a node is copied before the node)
+            const auto &tn = tree->nodes();
+            std::vector<long> index(tn.size(), -1);
+
+            for (size_t i = 0; i < tn.size() && n < max; ++i) {
+
+                const auto &node = tn[i];
+                if (i != 0 && node.start - mc.s() >= distance)
+                    continue;
+
+                index[i] = static_cast<long>(n);
+
+                auto &hn = nodes[n++];
+                hn.id = node.edge->id().c_str();
+                hn.edge = static_cast<unsigned long>(node.edge->handle());
+                hn.parent = node.parent == HorizonTree::NONE ? -1 : index[node.parent];
+                hn.distance = node.start - mc.s();
+                hn.length = node.edge->length();
+                hn.probability = node.probability;
+
+            }
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+
+    err_type_t _setPathHysteresis(id_type_t agentID, double factor, double lenFront, double lenBack) {
+
+        const int ERR = 270;
+
+        try {
+
+            // check if agent already registered
+            Agent *ag = nullptr;
+            auto err = _basicCheckAgent(agentID, &ag);
+            if (err != 0)
+                return ERR + err;
+
+            // check factor
+            if (!(factor >= 1.0))
+                return ERR + 5;
+
+            // check lengths
+            if (!(lenFront >= 0.0) || !(lenBack >= 0.0))
+                return ERR + 6;
+
+            ag->hysteresis = factor;
+            ag->requested[0] = lenFront;
+            ag->requested[1] = lenBack;
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+
+    // instrumented library functions
+
+    err_type_t clear() {
+
+        return _measure(_Function::CLEAR, [&]() { return _clear(); });
+
+    }
+
+
+    err_type_t loadMap(const char *filename, id_type_t &id) {
+
+        return _measure(_Function::LOAD_MAP, [&]() { return _loadMap(filename, MapOptions{0.0, 0}, id); });
+
+    }
+
+
+    err_type_t loadMap(const char *filename, MapOptions options, id_type_t &id) {
+
+        return _measure(_Function::LOAD_MAP, [&]() { return _loadMap(filename, options, id); });
+
+    }
+
+
+    err_type_t loadMapAsync(const char *filename, id_type_t &id) {
+
+        return _measure(_Function::LOAD_MAP_ASYNC, [&]() { return _loadMapAsync(filename, MapOptions{0.0, 0}, id); });
+
+    }
+
+
+    err_type_t loadMapAsync(const char *filename, MapOptions options, id_type_t &id) {
+
+        return _measure(_Function::LOAD_MAP_ASYNC, [&]() { return _loadMapAsync(filename, options, id); });
+
+    }
+
+
+    err_type_t mapStatus(id_type_t id, MapStatus &status) {
+
+        return _measure(_Function::MAP_STATUS, [&]() { return _mapStatus(id, status); });
+
+    }
+
+
+    err_type_t unloadMap(id_type_t id) {
+
+        return _measure(_Function::UNLOAD_MAP, [&]() { return _unloadMap(id); });
+
+    }
+
+
+    err_type_t registerAgent(id_type_t agentID, id_type_t mapID) {
+
+        return _measure(_Function::REGISTER_AGENT, [&]() { return _registerAgent(agentID, mapID); });
+
+    }
+
+
+    err_type_t unregisterAgent(id_type_t agentID) {
+
+        return _measure(_Function::UNREGISTER_AGENT, [&]() { return _unregisterAgent(agentID); });
+
+    }
+
+
+    err_type_t setTrack(id_type_t agentID, const char **trackElements, unsigned long n) {
+
+        return _measure(_Function::SET_TRACK, [&]() { return _setTrack(agentID, trackElements, n); });
+
+    }
+
+
+    err_type_t setTrack(id_type_t agentID, const TrackHandle *roads, unsigned long n) {
+
+        return _measure(_Function::SET_TRACK, [&]() { return _setTrack(agentID, roads, n); });
+
+    }
+
+
+    err_type_t getPosition(id_type_t agentID, Position &pos) {
+
+        return _measure(_Function::GET_POSITION, [&]() { return _getPosition(agentID, pos); });
+
+    }
+
+
+    err_type_t setMapPosition(id_type_t agentID, MapPosition mapPos, double &lenFront, double &lenBack) {
+
+        return _measure(_Function::SET_MAP_POSITION, [&]() {
+            return _setMapPosition(agentID, mapPos, lenFront, lenBack);
+        });
+
+    }
+
+
+    err_type_t setMapPosition(id_type_t agentID, MapHandlePosition mapPos, double &lenFront, double &lenBack) {
+
+        return _measure(_Function::SET_MAP_POSITION, [&]() {
+            return _setMapPosition(agentID, mapPos, lenFront, lenBack);
+        });
+
+    }
+
+
+    err_type_t getMapPosition(id_type_t agentID, MapPosition &mapPos) {
+
+        return _measure(_Function::GET_MAP_POSITION, [&]() { return _getMapPosition(agentID, mapPos); });
+
+    }
+
+
+    err_type_t getMapPosition(id_type_t agentID, MapHandlePosition &mapPos) {
+
+        return _measure(_Function::GET_MAP_POSITION, [&]() { return _getMapPosition(agentID, mapPos); });
+
+    }
+
+
+    err_type_t match(id_type_t agentID, Position pos, double ds, MapPosition &mapPos) {
+
+        return _measure(_Function::MATCH, [&]() { return _match(agentID, pos, ds, mapPos); });
+
+    }
+
+
+    err_type_t move(id_type_t agentID, double distance, double lateralPosition, double &lenFront, double &lenBack) {
+
+        return _measure(_Function::MOVE, [&]() {
+            return _move(agentID, distance, lateralPosition, lenFront, lenBack);
+        });
+
+    }
+
+
+    err_type_t switchLane(id_type_t agentID, int laneOffset) {
+
+        return _measure(_Function::SWITCH_LANE, [&]() { return _switchLane(agentID, laneOffset); });
+
+    }
+
+
+    err_type_t horizon(id_type_t agentID, const double *gridPoints, HorizonInformation *horizon, unsigned long n) {
+
+        return _measure(_Function::HORIZON, [&]() { return _horizon(agentID, gridPoints, horizon, n); });
+
+    }
+
+
+    err_type_t objects(id_type_t agentID, ObjectInformation *obj, unsigned long &n) {
+
+        return _measure(_Function::OBJECTS, [&]() { return _objects(agentID, obj, n); });
+
+    }
+
+
+    err_type_t lanes(id_type_t agentID, LaneInformation *lanes, unsigned long &n) {
+
+        return _measure(_Function::LANES, [&]() { return _lanes(agentID, lanes, n); });
+
+    }
+
+
+    err_type_t targets(id_type_t agentID, TargetInformation *targets, unsigned long &n) {
+
+        return _measure(_Function::TARGETS, [&]() { return _targets(agentID, targets, n); });
+
+    }
+
+
+    err_type_t locate(id_type_t mapID, double x, double y, MapPosition *positions, unsigned long &n) {
+
+        return _measure(_Function::LOCATE, [&]() { return _locate(mapID, x, y, NAN, positions, n); });
+
+    }
+
+
+    err_type_t locate(id_type_t mapID, double x, double y, double heading, MapPosition *positions, unsigned long &n) {
+
+        return _measure(_Function::LOCATE, [&]() { return _locate(mapID, x, y, heading, positions, n); });
+
+    }
+
+
+    err_type_t matchGlobal(id_type_t mapID, Position pos, MapPosition &mapPos) {
+
+        return _measure(_Function::MATCH_GLOBAL, [&]() { return _matchGlobal(mapID, &pos, &mapPos, 1); });
+
+    }
+
+
+    err_type_t matchGlobal(id_type_t mapID, const Position *pos, MapPosition *mapPos, unsigned long n) {
+
+        return _measure(_Function::MATCH_GLOBAL, [&]() { return _matchGlobal(mapID, pos, mapPos, n); });
+
+    }
+
+
+    err_type_t route(id_type_t agentID, const char *targetEdge, double targetS) {
+
+        return _measure(_Function::ROUTE, [&]() { return _route(agentID, targetEdge, targetS); });
+
+    }
+
+
+    err_type_t edgeHandle(id_type_t mapID, const char *edgeID, unsigned long &handle) {
+
+        return _measure(_Function::EDGE_HANDLE, [&]() { return _edgeHandle(mapID, edgeID, handle); });
+
+    }
+
+
+    err_type_t roadHandle(id_type_t mapID, const char *roadID, unsigned long &handle) {
+
+        return _measure(_Function::ROAD_HANDLE, [&]() { return _roadHandle(mapID, roadID, handle); });
+
+    }
+
+
+    err_type_t horizonTree(id_type_t agentID, double distance, unsigned long depth, HorizonTreeNode *nodes,
+                           unsigned long &n) {
+
+        return _measure(_Function::HORIZON_TREE, [&]() { return _horizonTree(agentID, distance, depth, nodes, n); });
+
+    }
+
+
+    err_type_t setPathHysteresis(id_type_t agentID, double factor, double lenFront, double lenBack) {
+
+        return _measure(_Function::SET_PATH_HYSTERESIS,
+                        [&]() { return _setPathHysteresis(agentID, factor, lenFront, lenBack); });
+
+    }
+
+
+    err_type_t metrics(char *text, unsigned long &n) {
+
+        const int ERR = 190;
+
+        try {
+
+            // write metrics
+            std::stringstream ss{};
+            _metrics.write(ss, "simmap", "function");
+            _errorCodes.write(ss, "simmap_error_codes_total", "code");
+
+            // check size
+            auto str = ss.str();
+            auto max = n;
+            n = static_cast<unsigned long>(str.size() + 1);
+
+            if (text == nullptr || max < n)
+                return ERR + 5;
+
+            // copy text
+            std::copy(str.c_str(), str.c_str() + n, text);
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
+
+    err_type_t statistics(CallStatistics *stats, unsigned long &n) {
+
+        const int ERR = 200;
+
+        try {
+
+            // check n
+            if (n == 0)
+                return ERR + 5;
+
+            // copy n to store max
+            n = std::min(n, static_cast<unsigned long>(_metrics.size()));
+
+            for (size_t i = 0; i < n; ++i) {
+
+                auto &c = _metrics.at(i);
+                auto calls = c.calls.load(std::memory_order_relaxed);
+
+                stats[i].name = _metrics.name(i).c_str();
+                stats[i].calls = calls;
+                stats[i].errors = c.errors.load(std::memory_order_relaxed);
+                stats[i].meanLatency = calls == 0 ? 0.0 : c.latency.sum() / static_cast<double>(calls);
+                stats[i].p50Latency = c.latency.quantile(0.5);
+                stats[i].p99Latency = c.latency.quantile(0.99);
+                stats[i].p999Latency = c.latency.quantile(0.999);
+
+            }
+
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return ERR + 9;
+        }
+
+        return 0;
+
+    }
+
 } // namespace ::simmap
 
@@ -31,6 +31,7 @@
 #include <curve/Arc.h>
 #include <curve/Spiral.h>
 #include <curve/Poly3.h>
+#include <curve/Fresnel.h>
 
 // TODO: test ODR-Elements ParamPoly3 (and also Poly3)
 
@@ -263,6 +264,45 @@ TEST_F(CurveTest, Poly3) {
     EXPECT_NEAR(1.0, p3(0.5 * l).position.y, base::EPS_DISTANCE);
     EXPECT_NEAR(2.0, p3(1.0 * l).position.y, base::EPS_DISTANCE);
 
+
+    // curved polynomial: arc length (Simpson's rule) as reference
+    double ax[4] = {0.0, 0.0, 60.0, 0.0};
+    double ay[4] = {-4.0, 10.0, 0.0, 0.0};
+
+    auto arc = [](double t) {
+
+        size_t n = 2000;
+        double h = t / n, s = 0.0;
+
+        for (size_t i = 0; i <= n; ++i) {
+
+            double w = (i == 0 || i == n) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+            double u = h * i;
+
+            s += w * sqrt(3600.0 + pow(20.0 * u - 12.0 * u * u, 2));
+
+        }
+
+        return s * h / 3.0;
+
+    };
+
+    Poly3 crv(arc(1.0), ax, ay);
+    for (double t = 0.0; t <= 1.0; t += 0.05) {
+
+        auto p0 = crv(arc(t));
+
+        EXPECT_NEAR(t, crv.parameter(arc(t)), 1e-8);
+        EXPECT_NEAR(arc(t), crv.arcLength(t), 1e-6);
+        EXPECT_NEAR(60.0 * t, p0.position.x, 1e-6);
+        EXPECT_NEAR(10.0 * t * t - 4.0 * t * t * t, p0.position.y, 1e-6);
+
+        // curvature (signed)
+        double dx = 60.0, dy = 20.0 * t - 12.0 * t * t;
+        EXPECT_NEAR(dx * (20.0 - 24.0 * t) / pow(dx * dx + dy * dy, 1.5), p0.curvature, 1e-8);
+
+    }
+
 }
 
 
@@ -311,4 +351,371 @@ TEST_F(CurveTest, Curve) {
         EXPECT_TRUE(CurveTest::compareCurvePoints(base::CurvePoint(
                 {base::Vector3{s_x[i], s_y[i], 0.0}, s_t[i], s_k[i]}), crv(s_s[i]), 1e-12));
 
-}
\ No newline at end of file
+}
+
+
+TEST_F(CurveTest, Project) {
+
+    double d = 0.0;
+
+    // line (closed form)
+    auto line = createLine(-10.0, -20.0, M_PI * 0.5, 10.0);
+    EXPECT_NEAR(5.0, line.project({-12.0, -15.0, 0.0}, d), 1e-12);
+    EXPECT_NEAR(2.0, d, 1e-12);
+    EXPECT_NEAR(10.0, line.project({-8.0, 0.0, 0.0}, d), 1e-12);
+    EXPECT_NEAR(-2.0, d, 1e-12);
+
+    // arcs (closed form), left and right turn
+    for (double R : {100.0, -50.0}) {
+
+        auto arc = createArc(10.0, 10.0, 1.0, R, 0.5 * M_PI * std::abs(R));
+        for (double s : {0.0, 10.0, 50.0, 70.0}) {
+
+            EXPECT_NEAR(s, arc.project(arc.position(s, 3.0).position, d), 1e-9);
+            EXPECT_NEAR(3.0, d, 1e-9);
+
+        }
+
+        // behind the start
+        EXPECT_NEAR(0.0, arc.project(createLine(10.0, 10.0, 1.0, 5.0).position(-5.0, 0.0).position, d), 1e-9);
+
+    }
+
+    // spiral and poly3 (Newton)
+    auto spiral = createSpiral(-10.0, -20.0, M_PI * 0.5, 0.01, -0.02, 80.0);
+    auto p3 = createPoly3(sqrt(5.0), 0.0, 0.0, 1.0, 2.0, 1.0, 2.0, 1.0, 2.0);
+
+    for (double s : {0.5, 10.0, 40.0, 79.0}) {
+
+        EXPECT_NEAR(s, spiral.project(spiral.position(s, -2.0).position, d), 1e-9);
+        EXPECT_NEAR(-2.0, d, 1e-9);
+
+    }
+
+    EXPECT_NEAR(0.5 * sqrt(5.0), p3.project({0.0, 1.25, 0.0}, d), 1e-9);
+    EXPECT_NEAR(sqrt(0.3125), d, 1e-9);
+
+    // curve (global and local search)
+    createTestPoints();
+
+    Curve crv;
+    createCurve(&crv, 0.0, 0.0, 0.0, s_sC, s_kC);
+
+    for (double s : {5.0, 45.0, 130.0, 200.0, 270.0}) {
+
+        auto point = crv.position(s, 1.5).position;
+
+        EXPECT_NEAR(s, crv.project(point, d), 1e-9);
+        EXPECT_NEAR(1.5, d, 1e-9);
+        EXPECT_NEAR(s, crv.project(point, d, s - 5.0), 1e-9);
+        EXPECT_NEAR(1.5, d, 1e-9);
+
+    }
+
+}
+
+
+TEST_F(CurveTest, Fresnel) {
+
+    // integrate numerically (Simpson's rule)
+    auto integrate = [](double x, double &s, double &c) {
+
+        size_t n = 2000;
+        double h = x / n;
+
+        s = 0.0;
+        c = 0.0;
+
+        for (size_t i = 0; i <= n; ++i) {
+
+            double w = (i == 0 || i == n) ? 1.0 : (i % 2 == 1 ? 4.0 : 2.0);
+            double t = h * i;
+
+            s += w * sin(M_PI_2 * t * t);
+            c += w * cos(M_PI_2 * t * t);
+
+        }
+
+        s *= h / 3.0;
+        c *= h / 3.0;
+
+    };
+
+    double s, c, sr, cr;
+    for (double x = -1.0; x <= 1.0; x += 0.05) {
+
+        integrate(x, sr, cr);
+
+        EXPECT_TRUE(fresnelSeries(x, s, c));
+        EXPECT_NEAR(sr, s, 1e-13);
+        EXPECT_NEAR(cr, c, 1e-13);
+
+    }
+
+    // out of range
+    EXPECT_FALSE(fresnelSeries(1.5, s, c));
+
+    // spiral with arguments in and out of the range of the series: the position must be continuous
+    auto spiral = createSpiral(0.0, 0.0, 0.0, 0.0, 0.04, 100.0);
+    for (double x = 85.0; x < 92.0; x += 0.1) {
+
+        auto p0 = spiral(x);
+        auto p1 = spiral(x + 0.1);
+
+        EXPECT_NEAR(0.1, sqrt(pow(p1.position.x - p0.position.x, 2) + pow(p1.position.y - p0.position.y, 2)), 1e-4);
+
+    }
+
+}
+
+
+TEST_F(CurveTest, Bake) {
+
+    createTestPoints();
+
+    // create exact and baked curve
+    Curve exact, crv;
+    createCurve(&exact, 10.0, -5.0, 3.0, s_sC, s_kC);
+    createCurve(&crv, 10.0, -5.0, 3.0, s_sC, s_kC);
+
+    EXPECT_FALSE(crv.baked());
+    crv.bake(1e-3);
+    EXPECT_TRUE(crv.baked());
+
+    // compare with the exact evaluation (angle is unwrapped)
+    for (double s = 0.0; s <= crv.length(); s += 0.37) {
+
+        auto p0 = exact(s);
+        auto p1 = crv(s);
+
+        EXPECT_NEAR(p0.position.x, p1.position.x, 1e-3);
+        EXPECT_NEAR(p0.position.y, p1.position.y, 1e-3);
+        EXPECT_NEAR(0.0, base::angleDiff(p0.angle, p1.angle), 1e-3);
+        EXPECT_NEAR(p0.curvature, p1.curvature, 0.02);
+
+    }
+
+    // test bounds
+    EXPECT_THROW(crv(-1.0), std::invalid_argument);
+    EXPECT_THROW(crv(crv.length() + 1.0), std::invalid_argument);
+
+    // switch back to the exact evaluation
+    crv.bake(0.0);
+    EXPECT_FALSE(crv.baked());
+
+    for(size_t i = 0; i < s_s.size(); ++i)
+        EXPECT_TRUE(CurveTest::compareCurvePoints(exact(s_s[i]), crv(s_s[i]), 1e-12));
+
+}
+
+
+TEST_F(CurveTest, BakeDiscontinuous) {
+
+    // line followed by an arc (curvature jumps)
+    Curve exact, crv;
+    for (auto c : {&exact, &crv}) {
+        c->emplace(0.0, new Line(100.0));
+        c->emplace(100.0, new Arc(100.0, 0.02));
+        c->length(200.0);
+        c->startPoint({{0.0, 0.0, 0.0}, 0.0, 0.0});
+    }
+
+    crv.bake(0.01);
+    EXPECT_TRUE(crv.baked());
+
+    auto compare = [&exact, &crv]() {
+
+        for (double s = 0.0; s <= crv.length(); s += 0.37) {
+
+            auto p0 = exact(s);
+            auto p1 = crv(s);
+
+            EXPECT_NEAR(p0.position.x, p1.position.x, 0.01);
+            EXPECT_NEAR(p0.position.y, p1.position.y, 0.01);
+            EXPECT_NEAR(0.0, base::angleDiff(p0.angle, p1.angle), 0.01);
+
+        }
+
+        // at the border, the curvature of the arc is returned
+        EXPECT_NEAR(0.0, crv(99.9).curvature, 1e-9);
+        EXPECT_NEAR(0.02, crv(100.0).curvature, 1e-9);
+        EXPECT_NEAR(0.0, base::angleDiff(exact(108.0).angle, crv(108.0).angle), 0.01);
+
+        // batch evaluation
+        double s[3] = {99.9, 100.0, 108.0}, x[3], y[3], phi[3], kappa[3];
+        crv.pos(s, 3, x, y, phi, kappa);
+
+        EXPECT_NEAR(0.0, kappa[0], 1e-9);
+        EXPECT_NEAR(0.02, kappa[1], 1e-9);
+        EXPECT_NEAR(0.0, base::angleDiff(exact(108.0).angle, phi[2]), 0.01);
+
+    };
+
+    compare();
+
+    // move curve (curve is baked again)
+    exact.startPoint({{-3.0, 4.0, 0.0}, -1.0, 0.0});
+    crv.startPoint({{-3.0, 4.0, 0.0}, -1.0, 0.0});
+    EXPECT_TRUE(crv.baked());
+
+    compare();
+
+}
+
+
+TEST_F(CurveTest, Pack) {
+
+    createTestPoints();
+
+    // create exact and packed curve
+    Curve exact, crv;
+    createCurve(&exact, 10.0, -5.0, 3.0, s_sC, s_kC);
+    createCurve(&crv, 10.0, -5.0, 3.0, s_sC, s_kC);
+
+    EXPECT_FALSE(crv.packed());
+    crv.pack();
+    EXPECT_TRUE(crv.packed());
+
+    // the results are identical
+    for (double s = 0.0; s <= crv.length(); s += 0.37) {
+
+        auto p0 = exact(s);
+        auto p1 = crv(s);
+
+        EXPECT_DOUBLE_EQ(p0.position.x, p1.position.x);
+        EXPECT_DOUBLE_EQ(p0.position.y, p1.position.y);
+        EXPECT_DOUBLE_EQ(p0.angle, p1.angle);
+        EXPECT_DOUBLE_EQ(p0.curvature, p1.curvature);
+        EXPECT_DOUBLE_EQ(exact.curvature(s), crv.curvature(s));
+
+    }
+
+    // test bounds
+    EXPECT_THROW(crv(-1.0), std::invalid_argument);
+    EXPECT_THROW(crv(crv.length() + 1.0), std::invalid_argument);
+
+    // move curve (storage is updated)
+    exact.startPoint({{-3.0, 4.0, 0.0}, -1.0, 0.0});
+    crv.startPoint({{-3.0, 4.0, 0.0}, -1.0, 0.0});
+
+    for(size_t i = 0; i < s_s.size(); ++i)
+        EXPECT_TRUE(CurveTest::compareCurvePoints(exact(s_s[i]), crv(s_s[i]), 1e-12));
+
+    // curve with a polynomial
+    double x[4] = {0.0, 0.0, 10.0, 0.0};
+    double y[4] = {-2.0, 3.0, 0.0, 0.0};
+
+    Curve poly, polyExact;
+    for (auto c : {&poly, &polyExact}) {
+        c->emplace(0.0, new Line(10.0));
+        c->emplace(10.0, new Poly3(10.0, x, y));
+        c->length(20.0);
+        c->startPoint({{0.0, 0.0, 0.0}, 0.5, 0.0});
+    }
+
+    poly.pack();
+
+    for (double s = 0.0; s <= poly.length(); s += 0.37) {
+
+        auto p0 = polyExact(s);
+        auto p1 = poly(s);
+
+        EXPECT_DOUBLE_EQ(p0.position.x, p1.position.x);
+        EXPECT_DOUBLE_EQ(p0.position.y, p1.position.y);
+        EXPECT_DOUBLE_EQ(p0.angle, p1.angle);
+        EXPECT_DOUBLE_EQ(p0.curvature, p1.curvature);
+        EXPECT_DOUBLE_EQ(polyExact.curvature(s), poly.curvature(s));
+
+    }
+
+    EXPECT_TRUE(CurveTest::compareCurvePoints(polyExact(20.0), poly(20.0), 1e-12));
+
+}
+
+
+TEST_F(CurveTest, Batch) {
+
+    createTestPoints();
+
+    Curve crv;
+    createCurve(&crv, 10.0, -5.0, 3.0, s_sC, s_kC);
+
+    // positions (including the element borders)
+    std::vector<double> s{};
+    for (double v = 0.0; v < crv.length(); v += 0.37)
+        s.push_back(v);
+
+    s.insert(s.end(), {s_sC[5], s_sC[5], crv.length()});
+    std::sort(s.begin(), s.end());
+
+    auto n = s.size();
+    std::vector<double> x(n), y(n), phi(n), kappa(n);
+
+    // compare with the single evaluation (exact, packed and baked)
+    for (int mode = 0; mode < 3; ++mode) {
+
+        if (mode == 1)
+            crv.pack();
+        else if (mode == 2)
+            crv.bake(1e-3);
+
+        crv.pos(s.data(), n, x.data(), y.data(), phi.data(), kappa.data());
+
+        for (size_t i = 0; i < n; ++i) {
+
+            auto p = crv(s[i]);
+
+            EXPECT_DOUBLE_EQ(p.position.x, x[i]);
+            EXPECT_DOUBLE_EQ(p.position.y, y[i]);
+            EXPECT_DOUBLE_EQ(p.angle, phi[i]);
+            EXPECT_DOUBLE_EQ(p.curvature, kappa[i]);
+
+        }
+
+    }
+
+    // test bounds
+    s.push_back(crv.length() + 1.0);
+    EXPECT_THROW(crv.pos(s.data(), n + 1, x.data(), y.data(), phi.data(), kappa.data()), std::invalid_argument);
+
+    // curve with a polynomial (exact and packed)
+    double ax[4] = {0.0, 0.0, 10.0, 0.0};
+    double ay[4] = {-2.0, 3.0, 0.0, 0.0};
+
+    Curve poly;
+    poly.emplace(0.0, new Line(10.0));
+    poly.emplace(10.0, new Poly3(10.0, ax, ay));
+    poly.length(20.0);
+    poly.startPoint({{1.0, 2.0, 0.0}, -0.3, 0.0});
+
+    s.clear();
+    for (double v = 0.0; v < poly.length(); v += 0.37)
+        s.push_back(v);
+
+    s.insert(s.end(), {10.0, poly.length()});
+    std::sort(s.begin(), s.end());
+
+    n = s.size();
+    x.resize(n); y.resize(n); phi.resize(n); kappa.resize(n);
+
+    for (int mode = 0; mode < 2; ++mode) {
+
+        if (mode == 1)
+            poly.pack();
+
+        poly.pos(s.data(), n, x.data(), y.data(), phi.data(), kappa.data());
+
+        for (size_t i = 0; i < n; ++i) {
+
+            auto p = poly(s[i]);
+
+            EXPECT_DOUBLE_EQ(p.position.x, x[i]);
+            EXPECT_DOUBLE_EQ(p.position.y, y[i]);
+            EXPECT_DOUBLE_EQ(p.angle, phi[i]);
+            EXPECT_DOUBLE_EQ(p.curvature, kappa[i]);
+
+        }
+
+    }
+
+}
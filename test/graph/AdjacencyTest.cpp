@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-19.
+//
+
+#include <gtest/gtest.h>
+#include <graph/Graph.h>
+#include <graph/Edge.h>
+#include <graph/Adjacency.h>
+
+class AdjacencyEdge : public ::graph::Edge {
+
+    double _length = 0.0;
+    bool _forward = true;
+
+public:
+
+    explicit AdjacencyEdge(double len, std::string name) : _length(std::abs(len)), _forward(len >= 0.0) {
+        this->_id = std::move(name);
+    }
+
+    double length() const override {
+        return _length;
+    }
+
+    ObjectsList objects() const override {
+        return graph::Edge::ObjectsList();
+    }
+
+    base::Orientation orientation() const override {
+        return _forward ? base::Orientation::FORWARDS : base::Orientation::BACKWARDS;
+    }
+
+};
+
+
+TEST(AdjacencyTest, Frozen) {
+
+    /*
+     * l1 +<1--+-2-+--3---+4--+
+     * m  +>-----1------------+
+     * r1 +>1-+--2-+--3--+-4--+
+     */
+
+    std::vector<std::shared_ptr<AdjacencyEdge>> l1{}, r1{};
+    for (auto len : {5.0, 4.0, 7.0, 4.0})
+        l1.push_back(std::make_shared<AdjacencyEdge>(-len, "l1" + std::to_string(l1.size())));
+
+    for (auto len : {4.0, 5.0, 6.0, 5.0})
+        r1.push_back(std::make_shared<AdjacencyEdge>(len, "r1" + std::to_string(r1.size())));
+
+    auto m = std::make_shared<AdjacencyEdge>(20.0, "m");
+
+    // connect
+    std::vector<std::pair<double, std::vector<graph::Edge *>>> container;
+    container.push_back({0.0, {r1[0].get(), r1[1].get(), r1[2].get(), r1[3].get()}});
+    container.push_back({0.0, {m.get()}});
+    container.push_back({0.0, {l1[0].get(), l1[1].get(), l1[2].get(), l1[3].get()}});
+    ::graph::Graph::autoConnect(container);
+
+    // create graph and freeze
+    graph::Graph graph{};
+    for (const auto &e : l1)
+        graph[e->id()] = e;
+
+    for (const auto &e : r1)
+        graph[e->id()] = e;
+
+    graph[m->id()] = m;
+    graph.index();
+
+    // compare with the links and neighbors of the edges
+    for (const auto &e : graph) {
+
+        auto edge = e.second.get();
+        ASSERT_EQ(&graph._adjacency, edge->adjacency());
+
+        auto nexts = edge->adjacency()->nexts(edge->handle());
+        ASSERT_EQ(edge->nexts().size(), nexts.size());
+        for (size_t i = 0; i < nexts.size(); ++i) {
+            EXPECT_EQ(edge->nexts()[i].second, nexts.first[i].edge);
+            EXPECT_EQ(edge->nexts()[i].first, nexts.first[i].contact);
+        }
+
+        auto prevs = edge->adjacency()->prevs(edge->handle());
+        ASSERT_EQ(edge->prevs().size(), prevs.size());
+        for (size_t i = 0; i < prevs.size(); ++i)
+            EXPECT_EQ(edge->prevs()[i].second, prevs.first[i].edge);
+
+        for (auto side : {graph::Neighbored::Side::LEFT, graph::Neighbored::Side::RIGHT}) {
+            for (double s = 0.0; s <= edge->length(); s += 0.5) {
+
+                auto n0 = edge->neighbor(s, side, 1);
+                auto n1 = edge->adjacency()->neighbor(edge->handle(), s, side);
+
+                EXPECT_EQ(n0.second, n1.second);
+                EXPECT_NEAR(n0.first, n1.first, 1e-12);
+
+            }
+        }
+
+    }
+
+    // neighbors of the middle edge
+    auto right = graph._adjacency.neighbors(m->handle(), graph::Neighbored::Side::RIGHT);
+    ASSERT_EQ(4, right.size());
+    EXPECT_DOUBLE_EQ(9.0, right.first[2].start);
+    EXPECT_DOUBLE_EQ(15.0, right.first[2].end);
+    EXPECT_TRUE(right.first[2].sameDirection);
+
+    auto left = graph._adjacency.neighbors(m->handle(), graph::Neighbored::Side::LEFT);
+    ASSERT_EQ(4, left.size());
+    EXPECT_FALSE(left.first[0].sameDirection);
+
+}
+
+
+TEST(AdjacencyTest, Strips) {
+
+    /*
+     * l1 +<1--+-2-+--3---+4--+
+     * m  +>-----1------------+
+     * r1 +>1-+--2-+--3--+-4--+
+     * r2 +>----1----+----2---+
+     */
+
+    std::vector<std::shared_ptr<AdjacencyEdge>> l1{}, r1{}, r2{};
+    for (auto len : {5.0, 4.0, 7.0, 4.0})
+        l1.push_back(std::make_shared<AdjacencyEdge>(-len, "l1" + std::to_string(l1.size())));
+
+    for (auto len : {4.0, 5.0, 6.0, 5.0})
+        r1.push_back(std::make_shared<AdjacencyEdge>(len, "r1" + std::to_string(r1.size())));
+
+    for (auto len : {10.0, 10.0})
+        r2.push_back(std::make_shared<AdjacencyEdge>(len, "r2" + std::to_string(r2.size())));
+
+    auto m = std::make_shared<AdjacencyEdge>(20.0, "m");
+
+    // connect
+    std::vector<std::pair<double, std::vector<graph::Edge *>>> container;
+    container.push_back({0.0, {r2[0].get(), r2[1].get()}});
+    container.push_back({0.0, {r1[0].get(), r1[1].get(), r1[2].get(), r1[3].get()}});
+    container.push_back({0.0, {m.get()}});
+    container.push_back({0.0, {l1[0].get(), l1[1].get(), l1[2].get(), l1[3].get()}});
+    ::graph::Graph::autoConnect(container);
+
+    // create graph and freeze
+    graph::Graph graph{};
+    for (const auto &list : {l1, r1, r2})
+        for (const auto &e : list)
+            graph[e->id()] = e;
+
+    graph[m->id()] = m;
+    graph.index();
+
+    // compare the n-th neighbors with the neighbors of the edges (positions between the changes of the neighbors)
+    for (const auto &e : graph) {
+
+        auto edge = e.second.get();
+
+        for (auto side : {graph::Neighbored::Side::LEFT, graph::Neighbored::Side::RIGHT}) {
+            for (size_t n = 0; n < 5; ++n) {
+                for (double s = 0.25; s <= edge->length(); s += 0.5) {
+
+                    auto n0 = edge->neighbor(s, side, n);
+                    auto n1 = graph._adjacency.neighbor(edge->handle(), s, side, n);
+
+                    EXPECT_EQ(n0.second, n1.second);
+                    EXPECT_NEAR(n0.first, n1.first, 1e-12);
+
+                }
+            }
+        }
+
+    }
+
+    // strip of the middle edge (from the leftmost to the rightmost edge)
+    size_t index;
+    double position;
+    auto strip = graph._adjacency.strip(m->handle(), 12.0, index, position);
+
+    // (the strip is created from the backward edge l1[2], so r2 is the leftmost edge)
+    ASSERT_EQ(4, strip.size());
+    EXPECT_EQ(2, index);
+    EXPECT_EQ(r2[1].get(), strip.first[0].edge);
+    EXPECT_EQ(r1[2].get(), strip.first[1].edge);
+    EXPECT_EQ(m.get(), strip.first[2].edge);
+    EXPECT_EQ(l1[2].get(), strip.first[3].edge);
+    EXPECT_FALSE(strip.first[2].sameDirection);
+    EXPECT_TRUE(strip.first[3].sameDirection);
+    EXPECT_DOUBLE_EQ(12.0, strip.first[2].position(position));
+    EXPECT_DOUBLE_EQ(2.0, strip.first[0].position(position));
+    EXPECT_DOUBLE_EQ(4.0, strip.first[3].position(position));
+
+    // the strips are shared by the edges
+    EXPECT_EQ(7, graph._adjacency.strips());
+
+}
@@ -66,7 +66,7 @@ struct BasicPathObject : graph::Object {
 
 struct BasicPath : ::graph::Path {
 
-    explicit BasicPath(const ::graph::Path &p) : Path(p) {}
+    explicit BasicPath(const ::graph::Path &p) : ::graph::Path(p) {}
 
     const ::graph::Path::iterator_t *iterator() const { return &_it; }
 
@@ -122,7 +122,7 @@ TEST_F(BasicPathTest, Copy) {
     EXPECT_EQ(_segments.begin(), _it);
 
     // copy path
-    BasicPath p(*dynamic_cast<Path *>(this));
+    BasicPath p(*dynamic_cast<graph::Path *>(this));
     EXPECT_EQ(p.segments()->begin(), *p.iterator());
 
 }
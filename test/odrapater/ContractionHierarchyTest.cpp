@@ -0,0 +1,290 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-19.
+//
+
+#include <gtest/gtest.h>
+#include <odradapter/ODRAdapter.h>
+#include <server/ContractionHierarchy.h>
+#include <server/LaneEdge.h>
+#include <server/Router.h>
+#include <base/functions.h>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <queue>
+#include <set>
+
+
+TEST(ContractionHierarchyTest, Route) {
+
+    using namespace simmap::odra;
+    using namespace simmap::server;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    ContractionHierarchy hierarchy{};
+    EXPECT_TRUE(hierarchy.empty());
+
+    hierarchy.build(map._laneNetwork);
+    EXPECT_FALSE(hierarchy.empty());
+
+    // compare with the routes on the lanes
+    size_t routes = 0;
+    for (const auto &a : map._laneNetwork) {
+
+        auto start = dynamic_cast<const LaneEdge *>(a.second.get());
+        for (const auto &b : map._laneNetwork) {
+
+            auto target = dynamic_cast<const LaneEdge *>(b.second.get());
+            if (start->trackElement() == target->trackElement())
+                continue;
+
+            // every route on the lanes is also a route on the roads (lane changes are not restricted on the roads)
+            Track track{}, roads{};
+            if (!Router::route(start, 0.0, target, 0.0, track))
+                continue;
+
+            ASSERT_TRUE(hierarchy.route(start->trackElement(), target->trackElement(), roads));
+
+            // route on the roads is not longer
+            double len0 = 0.0, len1 = 0.0;
+            for (const auto &r : track)
+                len0 += r.second->length();
+
+            for (const auto &r : roads)
+                len1 += r.second->length();
+
+            EXPECT_GE(len0 + 1e-6, len1);
+            EXPECT_EQ(start->trackElement(), roads.front());
+            EXPECT_EQ(target->trackElement(), roads.back());
+
+            ++routes;
+
+        }
+
+    }
+
+    EXPECT_LT(0, routes);
+
+}
+
+
+TEST(ContractionHierarchyTest, Dijkstra) {
+
+    using namespace simmap::odra;
+    using namespace simmap::server;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    ContractionHierarchy hierarchy{};
+    hierarchy.build(map._laneNetwork);
+
+    // road graph (arcs to the roads of the successors, weighted by the length of the road)
+    std::map<Track::TrackElement, std::set<Track::TrackElement>> arcs{};
+    for (const auto &e : map._laneNetwork) {
+
+        auto lane = dynamic_cast<const LaneEdge *>(e.second.get());
+        if (lane == nullptr || lane->trackElement().second == nullptr)
+            continue;
+
+        arcs[lane->trackElement()];
+
+        for (const auto &c : lane->nexts()) {
+            auto next = dynamic_cast<const LaneEdge *>(c.second);
+            if (next != nullptr && next->trackElement().second != nullptr
+                && next->trackElement() != lane->trackElement())
+                arcs[lane->trackElement()].insert(next->trackElement());
+        }
+
+    }
+
+    typedef std::pair<double, Track::TrackElement> entry_t;
+
+    size_t routes = 0;
+    for (const auto &s : arcs) {
+
+        // plain dijkstra from the start road
+        std::map<Track::TrackElement, double> dist{{s.first, 0.0}};
+        std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>> queue{};
+        queue.push({0.0, s.first});
+
+        while (!queue.empty()) {
+
+            auto u = queue.top();
+            queue.pop();
+
+            if (u.first > dist.at(u.second))
+                continue;
+
+            for (const auto &v : arcs.at(u.second)) {
+
+                auto d = u.first + u.second.second->length();
+                auto it = dist.find(v);
+                if (it == dist.end() || d < it->second) {
+                    dist[v] = d;
+                    queue.push({d, v});
+                }
+
+            }
+
+        }
+
+        // compare with the routes of the hierarchy
+        for (const auto &t : arcs) {
+
+            if (s.first == t.first)
+                continue;
+
+            Track roads{};
+            auto found = hierarchy.route(s.first, t.first, roads);
+
+            auto it = dist.find(t.first);
+            ASSERT_EQ(it != dist.end(), found);
+            if (!found)
+                continue;
+
+            // the route is connected and as short as the shortest route
+            double len = 0.0;
+            for (auto r = roads.begin(); std::next(r) != roads.end(); ++r) {
+                EXPECT_EQ(1, arcs.at(*r).count(*std::next(r)));
+                len += r->second->length();
+            }
+
+            EXPECT_NEAR(it->second, len, 1e-6);
+            EXPECT_EQ(s.first, roads.front());
+            EXPECT_EQ(t.first, roads.back());
+
+            ++routes;
+
+        }
+
+    }
+
+    EXPECT_LT(0, routes);
+
+}
+
+
+TEST(ContractionHierarchyTest, Cache) {
+
+    using namespace simmap::odra;
+    using namespace simmap::server;
+
+    // copy map to the temporary directory (the hierarchy is saved next to the map)
+    auto filename = base::string_format("%s/map.xodr", TEMP_DIR);
+    {
+        std::ifstream src(base::string_format("%s/map.xodr", TRACKS_DIR), std::ios::binary);
+        std::ofstream dst(filename, std::ios::binary);
+        dst << src.rdbuf();
+    }
+
+    // load map with hierarchy (created and saved)
+    std::remove((filename + ".ch").c_str());
+
+    ODRAdapter map{};
+    map.loadFile(filename, 0.0, true);
+    EXPECT_FALSE(map._hierarchy.empty());
+
+    // load hierarchy from file
+    ContractionHierarchy hierarchy{};
+    EXPECT_TRUE(hierarchy.load(filename + ".ch", map._laneNetwork));
+
+    auto start = dynamic_cast<const LaneEdge *>(map._laneNetwork.begin()->second.get())->trackElement();
+    for (const auto &b : map._laneNetwork) {
+
+        auto target = dynamic_cast<const LaneEdge *>(b.second.get())->trackElement();
+
+        Track track0{}, track1{};
+        EXPECT_EQ(map._hierarchy.route(start, target, track0), hierarchy.route(start, target, track1));
+        EXPECT_EQ(track0, track1);
+
+    }
+
+    // file of another map is rejected
+    ODRAdapter circle{};
+    circle.loadFile(base::string_format("%s/CircleR100.xodr", TRACKS_DIR));
+    EXPECT_FALSE(hierarchy.load(filename + ".ch", circle._laneNetwork));
+    EXPECT_TRUE(hierarchy.empty());
+
+    std::remove((filename + ".ch").c_str());
+    std::remove(filename.c_str());
+
+}
+
+
+TEST(ContractionHierarchyTest, Rewired) {
+
+    using namespace simmap::odra;
+    using namespace simmap::server;
+
+    // read map
+    std::ifstream src(base::string_format("%s/map.xodr", TRACKS_DIR), std::ios::binary);
+    std::string xml((std::istreambuf_iterator<char>(src)), std::istreambuf_iterator<char>());
+
+    // connect road 7 to the start of road 3 instead of road 4 (same number of links and lengths)
+    auto begin = xml.find("<road id=\"7\"");
+    auto end = xml.find("</road>", begin);
+    ASSERT_NE(std::string::npos, begin);
+
+    auto road = xml.substr(begin, end - begin);
+    for (const auto &r : std::vector<std::pair<std::string, std::string>>{
+            {"<successor elementType=\"road\" elementId=\"4\"", "<successor elementType=\"road\" elementId=\"3\""},
+            {"<successor id=\"-1\"", "<successor id=\"-3\""}}) {
+
+        auto pos = road.find(r.first);
+        ASSERT_NE(std::string::npos, pos);
+        road.replace(pos, r.first.size(), r.second);
+
+    }
+
+    auto filename = base::string_format("%s/rewired.xodr", TEMP_DIR);
+    std::ofstream(filename, std::ios::binary) << xml.substr(0, begin) << road << xml.substr(end);
+
+    // save hierarchy of the original map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    ContractionHierarchy hierarchy{};
+    hierarchy.build(map._laneNetwork);
+    ASSERT_TRUE(hierarchy.save(filename + ".ch"));
+
+    // the file is accepted for the original map only
+    ODRAdapter rewired{};
+    rewired.loadFile(filename);
+
+    ContractionHierarchy loaded{};
+    EXPECT_TRUE(loaded.load(filename + ".ch", map._laneNetwork));
+    EXPECT_FALSE(loaded.load(filename + ".ch", rewired._laneNetwork));
+    EXPECT_TRUE(loaded.empty());
+
+    std::remove((filename + ".ch").c_str());
+    std::remove(filename.c_str());
+
+}
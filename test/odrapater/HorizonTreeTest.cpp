@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-20.
+//
+
+
+#include <gtest/gtest.h>
+#include <odradapter/ODRAdapter.h>
+#include <server/HorizonTree.h>
+#include <server/LaneEdge.h>
+#include <base/functions.h>
+#include <algorithm>
+#include <set>
+#include <string>
+
+
+TEST(HorizonTreeTest, Branches) {
+
+    using namespace simmap::odra;
+    using namespace simmap::server;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    HorizonTree tree{};
+    EXPECT_TRUE(tree.empty());
+
+    auto root = map.getEdge("R2-LS1-R1");
+    tree.build(root, 1000.0 + root->length(), HorizonTree::NONE);
+    ASSERT_FALSE(tree.empty());
+
+    const auto &nodes = tree.nodes();
+    EXPECT_EQ(root, nodes.front().edge);
+
+    // collect the branches of the leaves
+    std::set<std::string> branches{};
+    for (size_t i = 0; i < nodes.size(); ++i) {
+
+        // children are stored contiguously behind the parent
+        for (size_t j = nodes[i].first; j < nodes[i].first + nodes[i].children; ++j) {
+            EXPECT_EQ(i, nodes[j].parent);
+            EXPECT_NEAR(nodes[i].start + nodes[i].edge->length(), nodes[j].start, 1e-9);
+        }
+
+        if (nodes[i].children != 0)
+            continue;
+
+        std::string branch{};
+        for (auto j = i; j != HorizonTree::NONE; j = nodes[j].parent)
+            branch = nodes[j].edge->id() + (branch.empty() ? "" : " > " + branch);
+
+        branches.insert(branch);
+
+    }
+
+    std::set<std::string> expected{
+            "R2-LS1-R1 > R121-LS1-R1 > R1-LS1-R1 > R1-LS2-R1 > R1-LS3-R1 > R1-LS7-R1 > R1-LS9-R1",
+            "R2-LS1-R1 > R123-LS1-R1 > R3-LS1-R1"
+    };
+
+    EXPECT_EQ(expected, branches);
+
+    // most probable path ends in a leaf
+    auto path = tree.mostProbablePath();
+    ASSERT_LT(1, path.size());
+    EXPECT_EQ(0, nodes[path.back()].children);
+
+    for (size_t i = 1; i < path.size(); ++i) {
+        for (size_t j = nodes[path[i - 1]].first; j < nodes[path[i - 1]].first + nodes[path[i - 1]].children; ++j)
+            EXPECT_GE(nodes[path[i]].probability, nodes[j].probability);
+    }
+
+}
+
+
+TEST(HorizonTreeTest, Cache) {
+
+    using namespace simmap::odra;
+    using namespace simmap::server;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    auto root = map.getEdge("R2-LS1-R1");
+
+    // trees with lengths in the same step are shared
+    auto t0 = map._horizonTrees.tree(root, 10.0, 5);
+    auto t1 = map._horizonTrees.tree(root, 20.0, 5);
+    auto t2 = map._horizonTrees.tree(root, 20.0, 6);
+
+    EXPECT_EQ(t0.get(), t1.get());
+    EXPECT_NE(t0.get(), t2.get());
+    EXPECT_EQ(2, map._horizonTrees.size());
+
+    // re-indexing the map removes the trees
+    map.index();
+    EXPECT_EQ(0, map._horizonTrees.size());
+
+}
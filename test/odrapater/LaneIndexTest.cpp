@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-09.
+//
+
+#include <gtest/gtest.h>
+#include <odradapter/ODRAdapter.h>
+#include <server/LaneEdge.h>
+#include <base/functions.h>
+
+
+TEST(LaneIndexTest, Locate) {
+
+    using namespace simmap::odra;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/CircleR100.xodr", TRACKS_DIR));
+
+    // 8 lanes with width, each of about 157 m
+    EXPECT_LT(8 * 31, map._laneIndex.size());
+
+    // position in the center of lane R1 (radius 101.875)
+    double r = 101.875;
+    auto cand = map._laneIndex.locate(r * std::cos(0.5), r * std::sin(0.5));
+
+    ASSERT_EQ(1, cand.size());
+    EXPECT_EQ("R1-LS1-R1", cand[0].edge->id());
+    EXPECT_NEAR(50.0, cand[0].s, 1e-6);
+    EXPECT_NEAR(0.0, cand[0].d, 1e-6);
+
+    // position at the border between lane L1 and R1, with tolerance
+    cand = map._laneIndex.locate(100.0 * std::cos(0.5), 100.0 * std::sin(0.5), NAN, 0.1);
+
+    ASSERT_EQ(2, cand.size());
+    EXPECT_NEAR(1.875, std::abs(cand[0].d), 1e-6);
+    EXPECT_NEAR(1.875, std::abs(cand[1].d), 1e-6);
+
+    // filter by heading
+    cand = map._laneIndex.locate(100.0 * std::cos(0.5), 100.0 * std::sin(0.5), 0.5 - M_PI_2, 0.1);
+
+    ASSERT_EQ(1, cand.size());
+    EXPECT_EQ("R1-LS1-L1", cand[0].edge->id());
+    EXPECT_NEAR(157.0796326794897 - 50.0, cand[0].s, 1e-6);
+
+    // position outside of the road
+    cand = map._laneIndex.locate(0.0, 0.0);
+    EXPECT_TRUE(cand.empty());
+
+}
+
+
+TEST(LaneIndexTest, Match) {
+
+    using namespace simmap::odra;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/CircleR100.xodr", TRACKS_DIR));
+
+    simmap::server::LaneIndex::Candidate cand{};
+
+    // position in lane R1, without heading
+    double r = 102.0;
+    EXPECT_TRUE(map._laneIndex.match(r * std::cos(0.5), r * std::sin(0.5), NAN, cand));
+    EXPECT_EQ("R1-LS1-R1", cand.edge->id());
+    EXPECT_NEAR(50.0, cand.s, 1e-6);
+    EXPECT_NEAR(-0.125, cand.d, 1e-6);
+    EXPECT_NEAR(0.125 - 1.875, cand.score, 1e-6);
+
+    // position next to the road, heading in direction of lane L2
+    r = 92.0;
+    EXPECT_TRUE(map._laneIndex.match(r * std::cos(0.5), r * std::sin(0.5), 0.5 - M_PI_2, cand));
+    EXPECT_EQ("R1-LS1-L2", cand.edge->id());
+    EXPECT_NEAR(0.75, cand.score, 1e-6);
+
+    // position too far away
+    r = 80.0;
+    EXPECT_FALSE(map._laneIndex.match(r * std::cos(0.5), r * std::sin(0.5), NAN, cand));
+
+}
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2020 Jens Klimke <jens.klimke@rwth-aachen.de>. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Created by Jens Klimke on 2020-08-16.
+//
+
+#include <gtest/gtest.h>
+#include <odradapter/ODRAdapter.h>
+#include <server/LaneEdge.h>
+#include <base/functions.h>
+
+
+TEST(LaneTessellationTest, Polylines) {
+
+    using namespace simmap::odra;
+
+    // create map
+    ODRAdapter map{};
+    map.loadFile(base::string_format("%s/CircleR100.xodr", TRACKS_DIR));
+
+    // 8 lanes with width
+    EXPECT_EQ(8, map._laneTessellation.size());
+
+    auto edge = map.getEdge("R1-LS1-R1");
+    auto lane = map._laneTessellation.lane(edge);
+    ASSERT_NE(nullptr, lane);
+
+    // vertices from the start to the end of the lane
+    ASSERT_LT(2, lane->s.size());
+    EXPECT_DOUBLE_EQ(0.0, lane->s.front());
+    EXPECT_DOUBLE_EQ(edge->length(), lane->s.back());
+    EXPECT_EQ(lane->s.size(), lane->left.size());
+    EXPECT_EQ(lane->s.size(), lane->right.size());
+
+    // vertices on the borders (inner radius 100, outer radius 103.75)
+    for (size_t i = 0; i < lane->s.size(); ++i) {
+
+        EXPECT_NEAR(100.0, std::sqrt(pow(lane->left[i].x, 2) + pow(lane->left[i].y, 2)), 1e-6);
+        EXPECT_NEAR(101.875, std::sqrt(pow(lane->center[i].x, 2) + pow(lane->center[i].y, 2)), 1e-6);
+        EXPECT_NEAR(103.75, std::sqrt(pow(lane->right[i].x, 2) + pow(lane->right[i].y, 2)), 1e-6);
+
+    }
+
+    // chordal error (sagitta of the outer border)
+    for (size_t i = 1; i < lane->s.size(); ++i) {
+
+        auto h = lane->s[i] - lane->s[i - 1];
+        EXPECT_GE(LANE_TESSELLATION_TOLERANCE, h * h / (8.0 * 100.0) * 1.0375);
+
+    }
+
+    // point in lane
+    EXPECT_TRUE(map._laneTessellation.inside(edge, 101.0 * std::cos(0.5), 101.0 * std::sin(0.5)));
+    EXPECT_FALSE(map._laneTessellation.inside(edge, 99.0 * std::cos(0.5), 99.0 * std::sin(0.5)));
+    EXPECT_TRUE(map._laneTessellation.inside(map.getEdge("R1-LS1-L1"), 99.0 * std::cos(0.5), 99.0 * std::sin(0.5)));
+
+}
@@ -25,6 +25,7 @@
 #include <base/definitions.h>
 #include <base/functions.h>
 #include <server/Track.h>
+#include <server/Route.h>
 #include <server/Path.h>
 #include <gtest/gtest.h>
 #include <odradapter/ODRAdapter.h>
@@ -468,6 +469,84 @@ TEST(PathMapTest, createPath) {
 }
 
 
+TEST(PathMapTest, createPathOnRoute) {
+
+    using namespace simmap::server;
+
+    // create map and segment
+    auto map = new simmap::odra::ODRAdapter;
+    map->loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    auto rd2 = map->_roadNetwork.at("2").get();
+    auto rd4 = map->_roadNetwork.at("4").get();
+    auto rd18 = map->_roadNetwork.at("18").get();
+
+    // compile track
+    Route route(Track({{base::Orientation::BACKWARDS, rd2},
+                       {base::Orientation::BACKWARDS, rd4},
+                       {base::Orientation::FORWARDS,  rd18}}));
+
+    ASSERT_EQ(3u, route.size());
+    EXPECT_DOUBLE_EQ(0.0, route[0].start);
+    EXPECT_DOUBLE_EQ(rd2->length(), route[1].start);
+    EXPECT_DOUBLE_EQ(rd2->length() + rd4->length() + rd18->length(), route.length());
+    EXPECT_EQ(1u, route.find({base::Orientation::BACKWARDS, rd4}));
+    EXPECT_EQ(3u, route.find({base::Orientation::FORWARDS, rd4}));
+
+    // reversed route
+    auto rev = route.reversed();
+    EXPECT_EQ(rd18, rev[0].element.second);
+    EXPECT_EQ(base::Orientation::BACKWARDS, rev[0].element.first);
+    EXPECT_EQ(1u, rev.find({base::Orientation::FORWARDS, rd4}));
+
+    // create path (the index is moved to the road of the position)
+    size_t index = 0;
+    Path path;
+    Path::create(path, route, index, 0.0, 0.0, MapCoordinate(map->getEdge("R4-LS1-L4"), 0.0, 0.0));
+    EXPECT_EQ(1u, index);
+
+    // update path to get a length of 2000
+    path.updatePath(2000.0, 2000.0, route, index);
+    EXPECT_EQ(1u, index);
+    EXPECT_DOUBLE_EQ(path.distanceToHead(), 2000.0);
+    EXPECT_DOUBLE_EQ(path.distanceToBack(), 2000.0);
+
+}
+
+
+TEST(PathMapTest, sharedRoutes) {
+
+    using namespace simmap::server;
+
+    // create map and segment
+    auto map = new simmap::odra::ODRAdapter;
+    map->loadFile(base::string_format("%s/map.xodr", TRACKS_DIR));
+
+    Track track1({{base::Orientation::FORWARDS, map->_roadNetwork.at("1").get()},
+                  {base::Orientation::BACKWARDS, map->_roadNetwork.at("2").get()}});
+    Track track2({{base::Orientation::FORWARDS, map->_roadNetwork.at("1").get()}});
+
+    // identical tracks share the route
+    auto r1 = map->_routes.route(track1);
+    auto r2 = map->_routes.route(Track(track1));
+    auto r3 = map->_routes.route(track2);
+    EXPECT_EQ(r1, r2);
+    EXPECT_NE(r1, r3);
+    EXPECT_EQ(2u, map->_routes.size());
+
+    // the opposite route is precompiled once
+    EXPECT_EQ(r1->opposite(), r2->opposite());
+    EXPECT_EQ(track1.size(), r1->opposite()->size());
+    EXPECT_EQ(base::Orientation::FORWARDS, (*r1->opposite())[0].element.first);
+
+    // released routes are compiled again
+    r3.reset();
+    EXPECT_NE(nullptr, map->_routes.route(track2));
+    EXPECT_EQ(2u, map->_routes.size());
+
+}
+
+
 TEST(PathMapTest, generatePaths) {
 
 
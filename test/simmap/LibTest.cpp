@@ -433,6 +433,259 @@ TEST_F(LibraryTest, MatchPosition2) {
 }
 
 
+TEST_F(LibraryTest, MatchGlobal) {
+
+    init();
+
+    MapPosition mapPos{};
+    Position pos{};
+
+    double R = LibraryTest::R;
+    double dPhi = 0.1, phi = 0.1;
+    for (size_t i = 0; i < 10; ++i) {
+
+        auto s = phi * R;
+        pos.x = cos(phi) * (R + 2.0);
+        pos.y = sin(phi) * (R + 2.0);
+        pos.phi = phi + M_PI_2;
+
+        EXPECT_EQ(0, matchGlobal(1, pos, mapPos));
+        EXPECT_EQ(0, strcmp("R1-LS1-R1", mapPos.edgeID));
+        EXPECT_NEAR(s, mapPos.longPos, 1e-5);
+        EXPECT_NEAR(-0.125, mapPos.latPos, 1e-5);
+
+        phi += dPhi;
+
+    }
+
+    // opposite heading
+    pos.phi += M_PI;
+    EXPECT_EQ(0, matchGlobal(1, pos, mapPos));
+    EXPECT_EQ(0, strcmp("R1-LS1-L1", mapPos.edgeID));
+
+    // batch with a position outside of the road
+    Position pos2[2] = {pos, {0.0, 0.0, 0.0, 0.0, 0.0}};
+    MapPosition mapPos2[2]{};
+
+    EXPECT_EQ(228, matchGlobal(1, pos2, mapPos2, 2));
+    EXPECT_EQ(0, strcmp("R1-LS1-L1", mapPos2[0].edgeID));
+    EXPECT_EQ(nullptr, mapPos2[1].edgeID);
+
+    // errors
+    EXPECT_EQ(225, matchGlobal(1, pos2, mapPos2, 0));
+    EXPECT_EQ(226, matchGlobal(9, pos, mapPos));
+
+}
+
+
+TEST_F(LibraryTest, Route) {
+
+    init();
+    initPaths();
+
+    // route along the circle (lane change included)
+    EXPECT_EQ(0, route(1, "R2-LS1-L1", 100.0));
+    EXPECT_EQ(0, route(1, "R1-LS2-R2", 50.0));
+
+    // position is kept
+    MapPosition mapPos{};
+    EXPECT_EQ(0, getMapPosition(1, mapPos));
+    EXPECT_EQ(0, strcmp("R1-LS1-R1", mapPos.edgeID));
+    EXPECT_NEAR(10.0, mapPos.longPos, 1e-9);
+
+    // lane of the opposite direction is not reachable
+    EXPECT_EQ(237, route(1, "R1-LS1-L1", 10.0));
+
+    // errors
+    EXPECT_EQ(0, registerAgent(10, 1));
+    EXPECT_EQ(236, route(10, "R1-LS1-R1", 10.0));
+    EXPECT_EQ(235, route(1, "not_existing", 10.0));
+    EXPECT_EQ(232, route(11, "R1-LS1-R1", 10.0));
+
+}
+
+
+TEST_F(LibraryTest, Handles) {
+
+    init();
+    initPaths();
+
+    // get handles
+    unsigned long edge = 0, road1 = 0, road2 = 0;
+    EXPECT_EQ(0, edgeHandle(1, "R1-LS1-R1", edge));
+    EXPECT_EQ(0, roadHandle(1, "1", road1));
+    EXPECT_EQ(0, roadHandle(1, "2", road2));
+    EXPECT_NE(road1, road2);
+
+    // set track and position by handles
+    TrackHandle track[2] = {{road1, 0}, {road2, 1}};
+    EXPECT_EQ(0, setTrack(1, track, 2));
+
+    double lenFront = 200.0;
+    double lenBack = 100.0;
+    EXPECT_EQ(0, setMapPosition(1, MapHandlePosition{edge, 20.0, 0.5}, lenFront, lenBack));
+    EXPECT_NEAR(200.0, lenFront, 1e-6);
+    EXPECT_NEAR(100.0, lenBack, 1e-6);
+
+    // get position by handle and by ID
+    MapHandlePosition mapPos{};
+    EXPECT_EQ(0, getMapPosition(1, mapPos));
+    EXPECT_EQ(edge, mapPos.edge);
+    EXPECT_NEAR(20.0, mapPos.longPos, 1e-9);
+    EXPECT_NEAR(0.5, mapPos.latPos, 1e-9);
+
+    MapPosition mapPos2{};
+    EXPECT_EQ(0, getMapPosition(1, mapPos2));
+    EXPECT_EQ(0, strcmp("R1-LS1-R1", mapPos2.edgeID));
+
+    // errors
+    EXPECT_EQ(245, edgeHandle(1, "not_existing", edge));
+    EXPECT_EQ(246, edgeHandle(9, "R1-LS1-R1", edge));
+    EXPECT_EQ(255, roadHandle(1, "not_existing", road1));
+
+    track[1].road = 1000;
+    EXPECT_EQ(65, setTrack(1, track, 2));
+    EXPECT_EQ(100, setMapPosition(1, MapHandlePosition{1000, 20.0, 0.0}, lenFront, lenBack));
+
+}
+
+
+TEST_F(LibraryTest, HorizonTree) {
+
+    init();
+    initPaths();
+
+    // tree along the circle
+    HorizonTreeNode nodes[64];
+    unsigned long n = 64;
+    EXPECT_EQ(0, horizonTree(1, 1000.0, 10, nodes, n));
+    ASSERT_LT(1, n);
+
+    // root is the current lane
+    EXPECT_EQ(0, strcmp("R1-LS1-R1", nodes[0].id));
+    EXPECT_EQ(-1, nodes[0].parent);
+    EXPECT_NEAR(-10.0, nodes[0].distance, 1e-9);
+
+    for (unsigned long i = 1; i < n; ++i) {
+
+        // parents are stored before the children, the lanes follow each other
+        ASSERT_LE(0, nodes[i].parent);
+        ASSERT_GT(static_cast<long>(i), nodes[i].parent);
+
+        const auto &parent = nodes[nodes[i].parent];
+        EXPECT_NEAR(parent.distance + parent.length, nodes[i].distance, 1e-9);
+        EXPECT_LT(nodes[i].distance, 1000.0);
+
+        // the loop ends the branch
+        for (auto j = nodes[i].parent; j != -1; j = nodes[j].parent)
+            EXPECT_NE(nodes[i].edge, nodes[j].edge);
+
+    }
+
+    // the probabilities of the children sum up to the probability of the parent
+    for (unsigned long i = 0; i < n; ++i) {
+
+        double sum = 0.0;
+        bool leaf = true;
+        for (unsigned long j = i + 1; j < n; ++j) {
+            if (nodes[j].parent == static_cast<long>(i)) {
+                sum += nodes[j].probability;
+                leaf = false;
+            }
+        }
+
+        if (!leaf)
+            EXPECT_NEAR(nodes[i].probability, sum, 1e-9);
+
+    }
+
+    // the tree is memoized
+    HorizonTreeNode nodes2[64];
+    unsigned long n2 = 64;
+    EXPECT_EQ(0, horizonTree(1, 1000.0, 10, nodes2, n2));
+    ASSERT_EQ(n, n2);
+    EXPECT_EQ(nodes[n - 1].edge, nodes2[n - 1].edge);
+
+    // only the current lane
+    n = 64;
+    EXPECT_EQ(0, horizonTree(1, 1000.0, 0, nodes, n));
+    EXPECT_EQ(1, n);
+
+    // errors
+    EXPECT_EQ(0, registerAgent(10, 1));
+    EXPECT_EQ(266, horizonTree(10, 100.0, 10, nodes, n));
+    EXPECT_EQ(262, horizonTree(11, 100.0, 10, nodes, n));
+
+    n = 0;
+    EXPECT_EQ(265, horizonTree(1, 100.0, 10, nodes, n));
+
+}
+
+
+TEST_F(LibraryTest, PathHysteresis) {
+
+    init();
+    initPaths();
+
+    EXPECT_EQ(0, setPathHysteresis(1, 2.0, 100.0, 100.0));
+
+    // path is trimmed above the high-water mark (the passed lengths are not used)
+    double lf = 0.0, lb = 0.0;
+    EXPECT_EQ(0, move(1, 1.0, 0.0, lf, lb));
+    EXPECT_NEAR(100.0, lf, 1e-6);
+    EXPECT_NEAR(100.0, lb, 1e-6);
+
+    // path is extended below the requested length, the back is kept
+    EXPECT_EQ(0, move(1, 1.0, 0.0, lf, lb));
+    EXPECT_NEAR(200.0, lf, 1e-6);
+    EXPECT_NEAR(101.0, lb, 1e-6);
+
+    // the requested lengths are raised to exactly the returned lengths
+    EXPECT_EQ(0, setPathHysteresis(1, 2.0, lf, lb));
+    EXPECT_EQ(0, move(1, 1.0, 0.0, lf, lb));
+    EXPECT_NEAR(400.0, lf, 1e-6);
+    EXPECT_NEAR(102.0, lb, 1e-6);
+
+    // the requested lengths are met (once around the circle)
+    EXPECT_EQ(0, setPathHysteresis(1, 2.0, 100.0, 100.0));
+    for (size_t i = 0; i < 700; ++i) {
+
+        lf = 0.0, lb = 0.0;
+        EXPECT_EQ(0, move(1, 1.0, 0.0, lf, lb));
+        EXPECT_LE(100.0 - 1e-6, lf);
+        EXPECT_GE(200.0 + 1e-6, lf);
+        EXPECT_LE(100.0 - 1e-6, lb);
+        EXPECT_GE(200.0 + 1e-6, lb);
+
+    }
+
+    // the returned lengths are passed to the next move (the requested lengths are kept)
+    for (size_t i = 0; i < 700; ++i) {
+
+        EXPECT_EQ(0, move(1, 1.0, 0.0, lf, lb));
+        EXPECT_LE(100.0 - 1e-6, lf);
+        EXPECT_GE(200.0 + 1e-6, lf);
+        EXPECT_LE(100.0 - 1e-6, lb);
+        EXPECT_GE(200.0 + 1e-6, lb);
+
+    }
+
+    // no hysteresis
+    EXPECT_EQ(0, setPathHysteresis(1, 1.0, 0.0, 0.0));
+
+    lf = 100.0, lb = 100.0;
+    EXPECT_EQ(0, move(1, 1.0, 0.0, lf, lb));
+    EXPECT_NEAR(100.0, lf, 1e-6);
+    EXPECT_NEAR(100.0, lb, 1e-6);
+
+    // errors
+    EXPECT_EQ(275, setPathHysteresis(1, 0.5, 100.0, 100.0));
+    EXPECT_EQ(276, setPathHysteresis(1, 2.0, -1.0, 100.0));
+    EXPECT_EQ(272, setPathHysteresis(11, 2.0, 100.0, 100.0));
+
+}
+
+
 TEST_F(LibraryTest, MatchAndUpdatePosition) {
 
     init();
@@ -23,6 +23,8 @@
 //
 
 
+#include <thread>
+#include <chrono>
 #include <gtest/gtest.h>
 #include <simmap/simmap.h>
 #include <base/functions.h>
@@ -73,4 +75,99 @@ TEST_F(LoadLibTest, LoadMultipleMaps) {
 
     EXPECT_EQ(0, clear());
 
-}
\ No newline at end of file
+}
+
+
+TEST_F(LoadLibTest, LoadMapsAsync) {
+
+    using namespace simmap;
+
+    simmap::id_type_t id1, id2;
+    simmap::MapStatus status1, status2;
+
+    EXPECT_EQ(0, loadMapAsync(base::string_format("%s/CircleR100.xodr", TRACKS_DIR).c_str(), id1));
+    EXPECT_EQ(1, id1);
+
+    EXPECT_EQ(0, loadMapAsync(base::string_format("%s/not_existing.xodr", TRACKS_DIR).c_str(), id2));
+    EXPECT_EQ(2, id2);
+
+    // wait for maps
+    do {
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        EXPECT_EQ(0, mapStatus(id1, status1));
+        EXPECT_EQ(0, mapStatus(id2, status2));
+
+    } while (status1 == MapStatus::LOADING || status2 == MapStatus::LOADING);
+
+    EXPECT_EQ(MapStatus::READY, status1);
+    EXPECT_EQ(MapStatus::FAILED, status2);
+
+    // register agents
+    EXPECT_EQ(0, registerAgent(1, id1));
+    EXPECT_EQ(46, registerAgent(2, id2));
+
+    // unload maps
+    EXPECT_EQ(0, unloadMap(id2));
+    EXPECT_EQ(185, mapStatus(id2, status2));
+    EXPECT_EQ(0, unloadMap(id1));
+    EXPECT_EQ(185, mapStatus(id1, status1));
+
+    // unload while loading (not waited for)
+    EXPECT_EQ(0, loadMapAsync(base::string_format("%s/CircleR100.xodr", TRACKS_DIR).c_str(), id1));
+    EXPECT_EQ(0, unloadMap(id1));
+    EXPECT_EQ(185, mapStatus(id1, status1));
+
+    // clear while loading
+    EXPECT_EQ(0, loadMapAsync(base::string_format("%s/CircleR100.xodr", TRACKS_DIR).c_str(), id1));
+    EXPECT_EQ(0, clear());
+    EXPECT_EQ(185, mapStatus(id1, status1));
+
+}
+
+
+TEST_F(LoadLibTest, Metrics) {
+
+    using namespace simmap;
+
+    // get number of registerAgent calls
+    auto calls = [] (const std::string &fn) -> unsigned long {
+
+        CallStatistics stats[32];
+        unsigned long n = 32;
+        EXPECT_EQ(0, statistics(stats, n));
+
+        for (size_t i = 0; i < n; ++i)
+            if (fn == stats[i].name)
+                return stats[i].calls;
+
+        return 0;
+
+    };
+
+    auto n0 = calls("registerAgent");
+
+    // register agent on not existing map
+    EXPECT_EQ(46, registerAgent(1, 99));
+    EXPECT_EQ(n0 + 1, calls("registerAgent"));
+
+    // error code above 255
+    EXPECT_EQ(272, setPathHysteresis(99, 2.0, 100.0, 100.0));
+
+    // get required size
+    unsigned long n = 0;
+    EXPECT_EQ(195, metrics(nullptr, n));
+    EXPECT_LT(0, n);
+
+    // get text
+    std::vector<char> text(n);
+    EXPECT_EQ(0, metrics(text.data(), n));
+
+    std::string str(text.data());
+    EXPECT_NE(std::string::npos, str.find("simmap_calls_total{function=\"registerAgent\"}"));
+    EXPECT_NE(std::string::npos, str.find("simmap_latency_seconds_bucket{function=\"move\",le=\"+Inf\"}"));
+    EXPECT_NE(std::string::npos, str.find("simmap_error_codes_total{code=\"46\"}"));
+    EXPECT_NE(std::string::npos, str.find("simmap_error_codes_total{code=\"272\"}"));
+
+}